@@ -0,0 +1,73 @@
+#ifndef BARRIER_BATCH_H
+#define BARRIER_BATCH_H
+
+#include "buffer.h"
+
+namespace vkc
+{
+	// collects barriers of many resources and records them with a single cmdPipelineBarrier2,
+	// image layouts are tracked as soon as a transition is added
+	class BarrierBatch final
+	{
+	public:
+		struct BufferBarrier
+		{
+			VkAccessFlags2        SrcAccessMask{};
+			VkAccessFlags2        DstAccessMask{};
+			VkPipelineStageFlags2 SrcStageMask{};
+			VkPipelineStageFlags2 DstStageMask{};
+
+			VkDeviceSize Offset{ 0 };
+			VkDeviceSize Size{ VK_WHOLE_SIZE };
+
+			// in case of synchronization between separate queues
+			uint32_t SrcQueue{ VK_QUEUE_FAMILY_IGNORED };
+			uint32_t DstQueue{ VK_QUEUE_FAMILY_IGNORED };
+		};
+
+		BarrierBatch() = default;
+
+		~BarrierBatch() = default;
+
+		BarrierBatch(BarrierBatch&&)                 = default;
+		BarrierBatch(BarrierBatch const&)            = delete;
+		BarrierBatch& operator=(BarrierBatch&&)      = default;
+		BarrierBatch& operator=(BarrierBatch const&) = delete;
+
+		// the same subresource must not be transitioned twice within one batch
+		BarrierBatch& Add(Image& image, Image::Transition const& transition);
+
+		BarrierBatch& Add(Buffer const& buffer, BufferBarrier const& barrier);
+
+		// barrier only when the access is a hazard against the tracked state of the whole image or needs another layout,
+		// source masks come from the tracker
+		BarrierBatch& Require(Image& image, Access const& access);
+
+		BarrierBatch& Require(Buffer& buffer, Access const& access);
+
+		// global barriers are merged into one
+		BarrierBatch& Add
+		(
+			VkPipelineStageFlags2   srcStageMask
+			, VkAccessFlags2        srcAccessMask
+			, VkPipelineStageFlags2 dstStageMask
+			, VkAccessFlags2        dstAccessMask
+		);
+
+		// records everything collected so far, does nothing when empty
+		void Flush(Context const& context, VkCommandBuffer commandBuffer);
+
+		[[nodiscard]] bool IsEmpty() const
+		{
+			return m_ImageBarriers.empty() && m_BufferBarriers.empty() && !m_HasMemoryBarrier;
+		}
+
+	private:
+		std::vector<VkImageMemoryBarrier2>  m_ImageBarriers;
+		std::vector<VkBufferMemoryBarrier2> m_BufferBarriers;
+		VkMemoryBarrier2                    m_MemoryBarrier{};
+		bool                                m_HasMemoryBarrier{ false };
+	};
+}
+
+#endif //BARRIER_BATCH_H
@@ -1,9 +1,15 @@
 #ifndef BUFFER_H
 #define BUFFER_H
+#include <memory>
+#include <optional>
 
+#include "buffer_slice.h"
 #include "command_buffer.h"
 #include "context.h"
 #include "image.h"
+#include "mapped_file.h"
+#include "memory_pool.h"
+#include "resource_state.h"
 
 namespace vkc
 {
@@ -14,6 +20,26 @@ namespace vkc
 	class Buffer final
 	{
 	public:
+		struct CopyRegion
+		{
+			VkDeviceSize SrcOffset{ 0 };
+			VkDeviceSize DstOffset{ 0 };
+			VkDeviceSize Size{ 0 };
+		};
+
+		// zero extent covers the whole mip level, zero row length and image height mean tightly packed
+		struct ImageRegion
+		{
+			VkDeviceSize BufferOffset{ 0 };
+			uint32_t     RowLength{ 0 };
+			uint32_t     ImageHeight{ 0 };
+			uint32_t     MipLevel{ 0 };
+			uint32_t     BaseLayer{ 0 };
+			uint32_t     LayerCount{ 1 };
+			VkOffset2D   Offset{};
+			VkExtent2D   Extent{};
+		};
+
 		~Buffer() = default;
 
 		Buffer(Buffer&&)                 = default;
@@ -26,31 +52,65 @@ namespace vkc
 			return m_Size;
 		}
 
+		// writes into non-coherent memory are flushed on the next Context::FlushDirty
 		template<typename DataType>
-		void UpdateData(DataType const& data)
+		void UpdateData(DataType const& data, VkDeviceSize offset = 0)
 		{
-			assert(m_Data);
 			if constexpr (!IsContainer<DataType>)
 			{
-				memcpy(m_Data, &data, sizeof(DataType));
+				WriteMapped(&data, sizeof(DataType), offset);
 			}
 			else
 			{
-				memcpy(m_Data, data.data(), data.size() * sizeof(data[0]));
+				WriteMapped(data.data(), data.size() * sizeof(data[0]), offset);
 			}
 		}
 
 		void CopyTo(Context const& context, CommandBuffer const& commandBuffer, Buffer const& dst) const;
 
+		void CopyTo(Context const& context, CommandBuffer const& commandBuffer, BufferSlice const& dst) const;
+
+		// merges adjacent and overlapping ranges that keep the same src to dst distance
+		// and records them with a single copy command
+		void CopyRegions
+		(Context const& context, CommandBuffer const& commandBuffer, Buffer const& dst, std::span<CopyRegion const> regions) const;
+
 		void CopyTo(Context const& context, CommandBuffer const& commandBuffer, Image const& dst) const;
 
+		// whole prebaked mip chains or cubemaps with one copy command, all regions have to share the current layout
+		void CopyTo
+		(Context const& context, CommandBuffer const& commandBuffer, Image const& dst, std::span<ImageRegion const> regions) const;
+
 		void Destroy(Context const& context) const;
 
+		// makes device writes visible to reads through the mapping, does nothing for coherent memory
+		void Invalidate(Context const& context, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+		// for buffers built with BuildAliased, the allocation stays owned by the caller and may be shared with other resources
+		void BindMemory(Context const& context, VmaAllocation allocation, VkDeviceSize offset = 0);
+
+		// contents become undefined, the next barrier waits for the accesses recorded in the previous occupant's state
+		void Discard(ResourceState const& previousOccupant = {})
+		{
+			m_State = previousOccupant;
+		}
+
+		[[nodiscard]] ResourceState const& GetState() const
+		{
+			return m_State;
+		}
+
 		[[nodiscard]] void *GetMappedData() const
 		{
 			return m_Data;
 		}
 
+		// memory is the file mapping itself, see BufferBuilder::BuildFromFile
+		[[nodiscard]] bool IsImported() const
+		{
+			return m_ImportedMemory != VK_NULL_HANDLE;
+		}
+
 		operator VkBuffer() const;
 
 		operator VkBuffer*()
@@ -65,11 +125,36 @@ namespace vkc
 
 	private:
 		friend class BufferBuilder;
+		friend class Defragmenter;
+		friend class BarrierBatch;
 		Buffer() = default;
+
+		void WriteMapped(void const* src, VkDeviceSize size, VkDeviceSize offset);
+
 		VkBuffer      m_Buffer{ VK_NULL_HANDLE };
 		VmaAllocation m_Allocation{ VK_NULL_HANDLE };
+		bool          m_OwnsAllocation{ true };
 		VkDeviceSize  m_Size{ 0 };
 		void*         m_Data{ nullptr };
+
+		// kept to recreate the buffer when its memory is relocated
+		VkBufferUsageFlags m_Usage{};
+		VkSharingMode      m_SharingMode{ VK_SHARING_MODE_EXCLUSIVE };
+
+		// only set for host visible memory without HOST_COHERENT
+		FlushQueue* m_FlushQueue{ nullptr };
+
+		// non-temporal stores, only used when requested and the memory is uncached
+		bool m_StreamingWrites{ false };
+
+		// null for memory not allocated through VMA
+		MemoryStats* m_MemoryStats{ nullptr };
+
+		ResourceState m_State{};
+
+		// imported buffers bypass VMA and keep the file mapped for as long as the memory lives
+		VkDeviceMemory              m_ImportedMemory{ VK_NULL_HANDLE };
+		std::shared_ptr<MappedFile> m_MappedFile;
 	};
 
 	class BufferBuilder final
@@ -92,15 +177,51 @@ namespace vkc
 
 		BufferBuilder& SetRequiredMemoryFlags(VkMemoryPropertyFlags flags);
 
+		BufferBuilder& SetPreferredMemoryFlags(VkMemoryPropertyFlags flags);
+
 		BufferBuilder& MapMemory(bool map = true);
 
-		[[nodiscard]] Buffer Build(VkBufferUsageFlags usage, VkDeviceSize size, bool addToQueue = true);
+		// memory usage and flags are then given by the pool
+		BufferBuilder& SetPool(VmaPool pool);
+
+		// UpdateData uses non-temporal stores if the buffer ends up in uncached (write-combined) memory
+		BufferBuilder& UseStreamingWrites(bool enable = true);
+
+		// shows up in VMA's stats string and debug utilities
+		BufferBuilder& SetName(std::string name);
+
+		// bucket the allocation is accounted under in Context::MemoryStats
+		BufferBuilder& SetCategory(std::string category);
+
+		[[nodiscard]] Buffer Build(VkBufferUsageFlags usage, VkDeviceSize size, bool addToQueue = true) const;
+
+		// buffer without memory, bind it with Buffer::BindMemory, memory settings of the builder are ignored
+		[[nodiscard]] Buffer BuildAliased(VkBufferUsageFlags usage, VkDeviceSize size, bool addToQueue = true);
+
+		// imports the file mapping as buffer memory through VK_EXT_external_memory_host when the extension is enabled
+		// and the mapping satisfies the import alignment, otherwise reads the file in chunks into a new host visible buffer,
+		// the imported buffer is read only from the host and usages the GPU can write through always take the copy
+		[[nodiscard]] Buffer BuildFromFile(std::filesystem::path const& path, VkBufferUsageFlags usage, bool addToQueue = true) const;
 
 	private:
+		[[nodiscard]] Buffer Create
+		(
+			VkBufferUsageFlags               usage
+			, VkDeviceSize                   size
+			, VmaAllocationCreateInfo const& allocationCreateInfo
+			, bool                           mapMemory
+			, bool                           addToQueue
+		) const;
+
+		[[nodiscard]] std::optional<Buffer> TryImport(std::shared_ptr<MappedFile> const& file, VkBufferUsageFlags usage, bool addToQueue) const;
+
 		Context&                m_Context;
 		VkBufferCreateInfo      m_BufferCreateInfo{};
 		VmaAllocationCreateInfo m_AllocationCreateInfo{};
 		bool                    m_MapMemory{ false };
+		bool                    m_StreamingWrites{ false };
+		std::string             m_Name;
+		std::string             m_Category;
 	};
 }
 
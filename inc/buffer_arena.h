@@ -0,0 +1,71 @@
+#ifndef BUFFER_ARENA_H
+#define BUFFER_ARENA_H
+
+#include "buffer.h"
+#include "buffer_slice.h"
+
+namespace vkc
+{
+	// owns a few large buffers and sub-allocates slices from them through VMA virtual blocks
+	class BufferArena final
+	{
+	public:
+		BufferArena() = delete;
+
+		// algorithm is either 0 (TLSF) or VMA_VIRTUAL_BLOCK_CREATE_LINEAR_ALGORITHM_BIT
+		BufferArena
+		(
+			Context&                     context
+			, VkBufferUsageFlags         usage
+			, VkDeviceSize               blockSize
+			, VkMemoryPropertyFlags      requiredFlags = 0
+			, VmaVirtualBlockCreateFlags algorithm     = 0
+		);
+
+		~BufferArena() = default;
+
+		BufferArena(BufferArena&&)                 = delete;
+		BufferArena(BufferArena const&)            = delete;
+		BufferArena& operator=(BufferArena&&)      = delete;
+		BufferArena& operator=(BufferArena const&) = delete;
+
+		// alignment of 0 uses the device offset alignment required by the arena usage
+		[[nodiscard]] BufferSlice Allocate(VkDeviceSize size, VkDeviceSize alignment = 0);
+
+		void Free(BufferSlice const& slice);
+
+		// frees every slice at once, blocks are kept for reuse
+		void Reset();
+
+		[[nodiscard]] Buffer const& GetBlockBuffer(uint32_t block) const
+		{
+			return m_Blocks[block].Storage;
+		}
+
+		[[nodiscard]] uint32_t GetBlockCount() const
+		{
+			return static_cast<uint32_t>(m_Blocks.size());
+		}
+
+	private:
+		struct Block
+		{
+			Buffer          Storage;
+			VmaVirtualBlock VirtualBlock;
+		};
+
+		void AddBlock(VkDeviceSize size);
+
+		Context& m_Context;
+
+		VkBufferUsageFlags         m_Usage;
+		VkDeviceSize               m_BlockSize;
+		VkMemoryPropertyFlags      m_RequiredFlags;
+		VmaVirtualBlockCreateFlags m_Algorithm;
+		VkDeviceSize               m_MinAlignment{ 1 };
+
+		std::vector<Block> m_Blocks;
+	};
+}
+
+#endif //BUFFER_ARENA_H
@@ -0,0 +1,28 @@
+#ifndef BUFFER_SLICE_H
+#define BUFFER_SLICE_H
+
+#include "vma_usage.h"
+
+namespace vkc
+{
+	// sub-range of a larger buffer handed out by BufferArena
+	struct BufferSlice
+	{
+		VkBuffer     Buffer{ VK_NULL_HANDLE };
+		VkDeviceSize Offset{ 0 };
+		VkDeviceSize Size{ 0 };
+
+		// mapped pointer to the start of the slice, only set for host visible arenas
+		void* Data{ nullptr };
+
+		VmaVirtualAllocation Allocation{ VK_NULL_HANDLE };
+		uint32_t             Block{ 0 };
+
+		operator VkDescriptorBufferInfo() const
+		{
+			return VkDescriptorBufferInfo{ Buffer, Offset, Size };
+		}
+	};
+}
+
+#endif //BUFFER_SLICE_H
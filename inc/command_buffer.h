@@ -7,6 +7,8 @@
 
 namespace vkc
 {
+	class CommandPool;
+
 	class CommandBuffer
 	{
 	public:
@@ -27,8 +29,26 @@ namespace vkc
 
 		[[nodiscard]] VkFence const& GetFence() const;
 
+		[[nodiscard]] uint64_t GetSubmissionCount() const
+		{
+			return m_SubmissionCount;
+		}
+
+		// checks whether the given submission of this buffer has finished executing on the GPU,
+		// keeps working after the buffer has been reused for later submissions
+		[[nodiscard]] bool HasCompleted(Context const& context, uint64_t submission);
+
+		// Begin, BeginSecondary and Reuse take the buffer back out of its pool if a submission handed it over
 		void Begin(Context const& context, VkCommandBufferUsageFlags usage = 0);
 
+		// secondary buffers continuing a dynamic rendering instance of the primary that executes them
+		void BeginSecondary
+		(
+			Context const&                                   context
+			, VkCommandBufferInheritanceRenderingInfo const& renderingInfo
+			, VkCommandBufferUsageFlags                      usage = 0
+		);
+
 		void End(Context const& context);
 
 		void Reset(Context const& context) const;
@@ -52,13 +72,20 @@ namespace vkc
 	private:
 		friend class CommandPool;
 
-		CommandBuffer(Context& context, VkCommandPool commandPool, VkCommandBuffer buffer);
+		CommandBuffer(Context& context, CommandPool& commandPool, VkCommandBuffer buffer);
 
+		CommandPool*    m_Owner;
 		VkCommandPool   m_Pool;
 		VkCommandBuffer m_CommandBuffer;
 		VkFence         m_Fence{};
 		VkFence         m_AssociatedFence{};
 		Status          m_Status{ Status::Ready };
+		uint64_t        m_SubmissionCount{};
+
+		// bookkeeping of the owning pool, pooled while the buffer sits in its ready or pending list
+		uint64_t m_TimelineValue{};
+		uint64_t m_PoolTicket{};
+		bool     m_Pooled{ false };
 	};
 }
 
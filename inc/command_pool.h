@@ -1,17 +1,27 @@
 #ifndef COMMAND_POOL_H
 #define COMMAND_POOL_H
-#include <list>
+#include <deque>
 
 #include "command_buffer.h"
 
 namespace vkc
 {
+	// submitted buffers wait in submission order until their work completed,
+	// Harvest moves them to a ready list that AllocateCommandBuffer pops without touching the driver,
+	// submitting hands a buffer to the pool, a caller keeping it takes it back with CommandBuffer::Begin or Reuse
 	class CommandPool final
 	{
 	public:
 		CommandPool() = delete;
 
-		CommandPool(Context& context, uint32_t queueIndex, uint32_t bufferCount, VkCommandPoolCreateFlags flags = 0);
+		CommandPool
+		(
+			Context&                   context
+			, uint32_t                 queueIndex
+			, uint32_t                 bufferCount
+			, VkCommandPoolCreateFlags flags = 0
+			, VkCommandBufferLevel     level = VK_COMMAND_BUFFER_LEVEL_PRIMARY
+		);
 
 		~CommandPool() = default;
 
@@ -20,8 +30,37 @@ namespace vkc
 		CommandPool& operator=(CommandPool&&)      = delete;
 		CommandPool& operator=(CommandPool const&) = delete;
 
+		// only harvests through fences when no buffer is ready, allocates a new buffer when none completed either
 		CommandBuffer& AllocateCommandBuffer(Context& context);
 
+		// hands back a buffer that was allocated but never submitted, submitted buffers return on their own
+		void Recycle(CommandBuffer& buffer);
+
+		// lets Harvest(completedValue) derive the completion of the last submission from the timeline value it signals
+		void TrackTimeline(CommandBuffer& buffer, uint64_t timelineValue);
+
+		// meant to run once per frame, stops at the first buffer still executing
+		void Harvest(Context const& context);
+
+		// no driver calls, completedValue is the counter of the semaphore passed to TrackTimeline,
+		// stops at the first buffer without a timeline value
+		void Harvest(uint64_t completedValue);
+
+		// resets every buffer at once and makes all of them ready,
+		// none of them may still be executing, including secondaries executed by a pending primary
+		void Reset(Context const& context);
+
+		// both may still count buffers taken back out of the pool, their entries are dropped lazily
+		[[nodiscard]] size_t GetReadyCount() const
+		{
+			return m_Ready.size();
+		}
+
+		[[nodiscard]] size_t GetPendingCount() const
+		{
+			return m_Pending.size();
+		}
+
 		void Destroy(Context const& context) const;
 
 		operator VkCommandPool*()
@@ -35,10 +74,35 @@ namespace vkc
 		}
 
 	private:
-		VkCommandPool m_Pool{};
+		friend class CommandBuffer;
+
+		// entries of buffers taken back out of the pool are skipped, the ticket tells them apart from newer entries
+		struct Entry
+		{
+			CommandBuffer* Buffer{};
+			uint64_t       Ticket{};
+		};
+
+		// called by CommandBuffer::Submit
+		void Track(CommandBuffer& buffer);
+
+		[[nodiscard]] static Entry Enlist(CommandBuffer& buffer);
+
+		[[nodiscard]] static bool IsCurrent(Entry const& entry);
+
+		CommandBuffer& AddCommandBuffer(Context& context, VkCommandBuffer commandBuffer);
+
+		VkCommandPool        m_Pool{};
+		VkCommandBufferLevel m_Level;
+
+		// deque to avoid breaking references when growing
+		std::deque<CommandBuffer> m_CommandBuffers;
+
+		// used as a stack, the most recently completed buffer is the most likely to still be cached
+		std::vector<Entry> m_Ready;
 
-		// list to avoid breaking references, it is read only sequentially everytime anyway
-		std::list<CommandBuffer> m_CommandBuffers;
+		// submissions on a queue complete in order, so this is sorted by completion
+		std::deque<Entry> m_Pending;
 	};
 }
 
@@ -1,20 +1,29 @@
 #ifndef CONTEXT_H
 #define CONTEXT_H
 #include "deletion_queue.h"
+#include "flush_queue.h"
+#include "memory_stats.h"
 
 #include "VkBootstrap.h"
 #include "vma_usage.h"
 
+#ifndef VKC_HEADLESS
 #include "GLFW/glfw3.h"
+#endif
 
 namespace vkc
 {
 	struct Context
 	{
+		// declared first so it outlives the deleters that untrack allocations
+		MemoryStats   MemoryStats;
 		DeletionQueue DeletionQueue;
 		VmaAllocator  Allocator;
+		FlushQueue    FlushQueue;
 
+#ifndef VKC_HEADLESS
 		GLFWwindow*                Window{};
+#endif
 		vkb::Instance              Instance;
 		vkb::InstanceDispatchTable InstanceDispatchTable;
 		VkSurfaceKHR               Surface{};
@@ -24,6 +33,49 @@ namespace vkc
 
 		VkQueue GraphicsQueue{};
 		VkQueue PresentQueue{};
+
+		// filled by DiscoverTransferQueue
+		VkQueue  TransferQueue{};
+		uint32_t TransferQueueFamily{ VK_QUEUE_FAMILY_IGNORED };
+
+		// prefers a transfer only family, then any family without graphics and finally shares the graphics queue
+		void DiscoverTransferQueue()
+		{
+			if (auto const dedicatedIndex = Device.get_dedicated_queue_index(vkb::QueueType::transfer))
+			{
+				TransferQueueFamily = dedicatedIndex.value();
+				TransferQueue       = Device.get_dedicated_queue(vkb::QueueType::transfer).value();
+			}
+			else if (auto const separateIndex = Device.get_queue_index(vkb::QueueType::transfer))
+			{
+				TransferQueueFamily = separateIndex.value();
+				TransferQueue       = Device.get_queue(vkb::QueueType::transfer).value();
+			}
+			else
+			{
+				auto const graphicsIndex = Device.get_queue_index(vkb::QueueType::graphics);
+				if (!graphicsIndex)
+					throw std::runtime_error("Failed to find a queue family for transfers " + graphicsIndex.error().message());
+				TransferQueueFamily = graphicsIndex.value();
+				TransferQueue       = GraphicsQueue;
+			}
+		}
+
+		// surface without a display, lets vkb::SwapchainBuilder work unchanged on headless machines,
+		// the instance needs VK_EXT_headless_surface enabled
+		void CreateHeadlessSurface()
+		{
+			VkHeadlessSurfaceCreateInfoEXT createInfo{};
+			createInfo.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+			if (InstanceDispatchTable.createHeadlessSurfaceEXT(&createInfo, nullptr, &Surface) != VK_SUCCESS)
+				throw std::runtime_error("Failed to create headless surface");
+		}
+
+		// flushes everything written through Buffer::UpdateData into non-coherent memory since the last call
+		void FlushDirty()
+		{
+			FlushQueue.Flush(Allocator);
+		}
 	};
 }
 
@@ -0,0 +1,120 @@
+#ifndef DEFRAGMENTER_H
+#define DEFRAGMENTER_H
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <variant>
+
+#include "buffer.h"
+
+namespace vkc
+{
+	// incremental VMA defragmentation moving tracked buffers and images to new memory,
+	// tracked resources have to be built with addToQueue = false and destroyed by their owner (never during a pass),
+	// mapped buffers and resources without TRANSFER_SRC usage are never moved
+	class Defragmenter final
+	{
+	public:
+		// invoked right after the resource got its new handle, views and descriptors referring to it have to be rewritten,
+		// cached views of Image::GetView are recreated on their next request
+		using RelocationCallback = std::function<void()>;
+
+		struct Budget
+		{
+			std::chrono::microseconds Time{ 500 };
+			VkDeviceSize              BytesPerPass{ 16 << 20 };
+			uint32_t                  AllocationsPerPass{ 64 };
+		};
+
+		Defragmenter() = delete;
+
+		explicit Defragmenter(Context& context);
+
+		~Defragmenter();
+
+		Defragmenter(Defragmenter&&)                 = delete;
+		Defragmenter(Defragmenter const&)            = delete;
+		Defragmenter& operator=(Defragmenter&&)      = delete;
+		Defragmenter& operator=(Defragmenter const&) = delete;
+
+		// the resource object itself must stay at the same address while tracked
+		void Track(Buffer& buffer, RelocationCallback callback = {});
+
+		void Track(Image& image, RelocationCallback callback = {});
+
+		void Untrack(VmaAllocation allocation);
+
+		void Begin(Budget const& budget, VmaDefragmentationFlags algorithm = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_FAST_BIT, VmaPool pool = VK_NULL_HANDLE);
+
+		// call once per frame before the tracked resources are used, finishes the previous pass once its submission
+		// completed and records the copies of the next one into commandBuffer, returns false when there is nothing left to move
+		bool Step(CommandBuffer& commandBuffer);
+
+		[[nodiscard]] bool IsRunning() const
+		{
+			return m_Defragmentation != VK_NULL_HANDLE;
+		}
+
+		[[nodiscard]] VmaDefragmentationStats const& GetStats() const
+		{
+			return m_Stats;
+		}
+
+	private:
+		struct Tracked
+		{
+			std::variant<Buffer*, Image*> Resource;
+			RelocationCallback            Callback;
+		};
+
+		// copies of a pass, recorded between a single pair of barriers
+		struct PassCommands
+		{
+			struct BufferCopy
+			{
+				VkBuffer     Src;
+				VkBuffer     Dst;
+				VkDeviceSize Size;
+			};
+
+			struct ImageCopy
+			{
+				VkImage                   Src;
+				VkImage                   Dst;
+				std::vector<VkImageCopy2> Regions;
+			};
+
+			std::vector<BufferCopy>            BufferCopies;
+			std::vector<ImageCopy>             ImageCopies;
+			std::vector<VkImageMemoryBarrier2> PreBarriers;
+			std::vector<VkImageMemoryBarrier2> PostBarriers;
+		};
+
+		[[nodiscard]] bool RelocateBuffer(PassCommands& commands, Buffer& buffer, VmaAllocation dstAllocation);
+		[[nodiscard]] bool RelocateImage(PassCommands& commands, Image& image, VmaAllocation dstAllocation);
+
+		void Record(CommandBuffer const& commandBuffer, PassCommands const& commands) const;
+
+		// returns false once VMA reports that there are no more moves
+		bool EndPass();
+		void End();
+
+		Context& m_Context;
+
+		Budget                    m_Budget{};
+		VmaDefragmentationContext m_Defragmentation{ VK_NULL_HANDLE };
+		VmaDefragmentationStats   m_Stats{};
+
+		std::unordered_map<VmaAllocation, Tracked> m_Tracked;
+
+		// current pass, old handles are destroyed once its copies completed
+		VmaDefragmentationPassMoveInfo m_Pass{};
+		CommandBuffer*                 m_PassOwner{};
+		uint64_t                       m_PassSubmission{};
+		std::vector<VkBuffer>          m_OldBuffers;
+		std::vector<VkImage>           m_OldImages;
+		std::vector<VkImageView>       m_OldViews;
+	};
+}
+
+#endif //DEFRAGMENTER_H
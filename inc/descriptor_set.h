@@ -1,8 +1,10 @@
 #ifndef DESCRIPTOR_SET_H
 #define DESCRIPTOR_SET_H
 
+#include <list>
 #include <span>
 
+#include "buffer_slice.h"
 #include "context.h"
 
 namespace vkc
@@ -23,6 +25,10 @@ namespace vkc
 		DescriptorSet& AddWriteDescriptor
 		(std::span<VkDescriptorBufferInfo> bufferInfos, VkDescriptorType type, uint32_t binding, uint32_t arrayElement);
 
+		// buffer infos for slices are kept by the set until Update
+		DescriptorSet& AddWriteDescriptor
+		(std::span<BufferSlice const> slices, VkDescriptorType type, uint32_t binding, uint32_t arrayElement);
+
 		void Update(Context const& context);
 
 		operator VkDescriptorSet() const
@@ -44,6 +50,9 @@ namespace vkc
 		VkDescriptorSet m_Set;
 
 		std::vector<VkWriteDescriptorSet> m_WriteDescriptorSets{};
+
+		// list to avoid breaking pointers stored in pending writes
+		std::list<std::vector<VkDescriptorBufferInfo>> m_SliceBufferInfos{};
 	};
 
 	class DescriptorSetBuilder final
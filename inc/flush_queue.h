@@ -0,0 +1,81 @@
+#ifndef FLUSH_QUEUE_H
+#define FLUSH_QUEUE_H
+#include <algorithm>
+#include <vector>
+
+#include "vma_usage.h"
+
+namespace vkc
+{
+	// collects ranges written into non-coherent mapped memory and flushes all of them with a single call
+	class FlushQueue final
+	{
+	public:
+		FlushQueue()  = default;
+		~FlushQueue() = default;
+
+		FlushQueue(FlushQueue&&)                 = delete;
+		FlushQueue(FlushQueue const&)            = delete;
+		FlushQueue& operator=(FlushQueue const&) = delete;
+		FlushQueue& operator=(FlushQueue&&)      = delete;
+
+		void Push(VmaAllocation allocation, VkDeviceSize offset, VkDeviceSize size)
+		{
+			m_Ranges.emplace_back(allocation, offset, size);
+		}
+
+		// drops pending ranges of an allocation that is about to be freed
+		void Discard(VmaAllocation allocation)
+		{
+			std::erase_if(m_Ranges, [allocation](Range const& range) { return range.Allocation == allocation; });
+		}
+
+		void Flush(VmaAllocator allocator)
+		{
+			if (m_Ranges.empty())
+				return;
+
+			std::ranges::sort(m_Ranges
+							  , [](Range const& lhs, Range const& rhs)
+							  {
+								  return lhs.Allocation != rhs.Allocation ? lhs.Allocation < rhs.Allocation : lhs.Offset < rhs.Offset;
+							  });
+
+			m_Allocations.clear();
+			m_Offsets.clear();
+			m_Sizes.clear();
+			for (Range const& range: m_Ranges)
+			{
+				// extend previous range if it touches or overlaps this one
+				if (!m_Allocations.empty() && m_Allocations.back() == range.Allocation && range.Offset <= m_Offsets.back() + m_Sizes.back())
+				{
+					m_Sizes.back() = std::max(m_Sizes.back(), range.Offset + range.Size - m_Offsets.back());
+					continue;
+				}
+				m_Allocations.emplace_back(range.Allocation);
+				m_Offsets.emplace_back(range.Offset);
+				m_Sizes.emplace_back(range.Size);
+			}
+
+			vmaFlushAllocations(allocator, static_cast<uint32_t>(m_Allocations.size()), m_Allocations.data(), m_Offsets.data(), m_Sizes.data());
+			m_Ranges.clear();
+		}
+
+	private:
+		struct Range
+		{
+			VmaAllocation Allocation;
+			VkDeviceSize  Offset;
+			VkDeviceSize  Size;
+		};
+
+		std::vector<Range> m_Ranges;
+
+		// kept between flushes to avoid reallocating every frame
+		std::vector<VmaAllocation> m_Allocations;
+		std::vector<VkDeviceSize>  m_Offsets;
+		std::vector<VkDeviceSize>  m_Sizes;
+	};
+}
+
+#endif //FLUSH_QUEUE_H
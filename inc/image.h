@@ -1,14 +1,22 @@
 #ifndef IMAGE_H
 #define IMAGE_H
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <memory>
 #include <optional>
 
 #include "command_pool.h"
 #include "context.h"
 #include "image_view.h"
+#include "memory_pool.h"
+#include "resource_state.h"
 #include "vma_usage.h"
 
 namespace vkc
 {
+	class TextureStream;
+
 	class Image final
 	{
 	public:
@@ -30,6 +38,13 @@ namespace vkc
 			, bool            addToQueue   = true
 		) const;
 
+		// cached, repeated requests return the same view, all views are destroyed together with the image,
+		// the reference dangles once the Defragmenter relocates the image or DestroyViews runs, ask again afterwards
+		[[nodiscard]] ImageView const& GetView(Context const& context, ImageViewDescription const& description) const;
+
+		// swapchain images have no deleter, their views have to be destroyed before the swapchain is recreated
+		void DestroyViews(Context const& context) const;
+
 		struct Transition
 		{
 			Transition() = default;
@@ -59,13 +74,37 @@ namespace vkc
 
 		void Destroy(Context const& context) const;
 
+		// for images built with BuildAliased, the allocation stays owned by the caller and may be shared with other resources
+		void BindMemory(Context const& context, VmaAllocation allocation, VkDeviceSize offset = 0);
+
+		// contents become undefined, e.g. when aliased memory was used by another resource in between,
+		// the next barrier waits for the accesses recorded in the previous occupant's state
+		void Discard(ResourceState const& previousOccupant = {});
+
 		void MakeTransition(Context const& context, VkCommandBuffer commandBuffer, Transition const& transition);
 
+		// fills levels 1.. of every layer from level 0 with a blit chain, the whole image ends up in finalLayout,
+		// needs TRANSFER_SRC and TRANSFER_DST usage
+		void GenerateMips
+		(
+			Context const&          context
+			, VkCommandBuffer       commandBuffer
+			, VkImageLayout         finalLayout   = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+			, VkPipelineStageFlags2 dstStageMask  = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT
+			, VkAccessFlags2        dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT
+		);
+
+		// full chain down to 1x1
+		[[nodiscard]] static uint32_t CalculateMipLevels(VkExtent2D extent)
+		{
+			return static_cast<uint32_t>(std::bit_width(std::max(extent.width, extent.height)));
+		}
+
 		[[nodiscard]] VkImageLayout GetLayout(uint32_t layer = 0, uint32_t mipLevel = 0) const
 		{
 			assert(mipLevel < m_MipLevels && layer < m_Layers);
 
-			return m_Layouts[layer][mipLevel];
+			return HasUniformLayout() ? m_Layouts[0] : m_Layouts[layer * m_MipLevels + mipLevel];
 		}
 
 		[[nodiscard]] VmaAllocation GetAllocation() const
@@ -73,11 +112,21 @@ namespace vkc
 			return m_Allocation;
 		}
 
+		[[nodiscard]] ResourceState const& GetState() const
+		{
+			return m_State;
+		}
+
 		[[nodiscard]] VkExtent2D const& GetExtent() const
 		{
 			return m_Extent;
 		}
 
+		[[nodiscard]] VkExtent2D GetMipExtent(uint32_t mipLevel) const
+		{
+			return { std::max(m_Extent.width >> mipLevel, 1u), std::max(m_Extent.height >> mipLevel, 1u) };
+		}
+
 		[[nodiscard]] VkImageAspectFlags GetAspect() const
 		{
 			return m_AspectFlags;
@@ -98,6 +147,24 @@ namespace vkc
 			return m_Format;
 		}
 
+		[[nodiscard]] VkImageTiling GetTiling() const
+		{
+			return m_Tiling;
+		}
+
+		// barriers generated by transitions of this image so far
+		[[nodiscard]] uint64_t GetEmittedBarrierCount() const
+		{
+			return m_EmittedBarriers;
+		}
+
+		// what the same transitions would have needed with one barrier per subresource of differing layouts,
+		// compared against GetEmittedBarrierCount it shows how much coalescing saved
+		[[nodiscard]] uint64_t GetPerSubresourceBarrierCount() const
+		{
+			return m_PerSubresourceBarriers;
+		}
+
 		static void ConvertFromSwapchainVkImages(Context& context, std::vector<Image>& convertedImages);
 
 		operator VkImage() const
@@ -117,21 +184,65 @@ namespace vkc
 
 	private:
 		friend class ImageBuilder;
+		friend class Defragmenter;
+		friend class BarrierBatch;
 		Image() = default;
 
+		// appends the barriers of a transition without recording them and updates the tracked layouts,
+		// the access state is left alone since BarrierBatch::Require already advanced it
+		void AppendTransition(std::vector<VkImageMemoryBarrier2>& barriers, Transition const& transition);
+
+		// explicit transitions over the whole image make their destination the only access to wait for
+		void SynchronizeState(Transition const& transition);
+
+		[[nodiscard]] ImageView MakeView(Context const& context, ImageViewDescription const& description) const;
+
 		[[nodiscard]] std::vector<VkImageMemoryBarrier2> MakeBarriersForEqualLayouts(Transition const& transition) const;
-		[[nodiscard]] std::vector<VkImageMemoryBarrier2> MakeBarriersForDifferentLayouts(Transition const& transition) const;
+		// greedy heuristic, not a minimal cover: rectangles of equal old layouts are grown along mips or layers first and
+		// the orientation yielding fewer barriers wins, exact when the layouts only change along one of the two axes
+		[[nodiscard]] std::vector<VkImageMemoryBarrier2> MakeGreedyBarriersForDifferentLayouts(Transition const& transition) const;
+
+		[[nodiscard]] bool HasUniformLayout() const
+		{
+			return m_Layouts.size() == 1;
+		}
+
+		[[nodiscard]] bool HasEqualLayouts(Transition const& transition) const;
+
+		// collapses back to a single entry whenever the whole image is set
+		void SetLayout(uint32_t baseLayer, uint32_t layerCount, uint32_t baseMipLevel, uint32_t levelCount, VkImageLayout layout);
+
+		VkImage m_Image{};
+
+		// single entry while all subresources share a layout, otherwise one per subresource, layer major
+		std::vector<VkImageLayout> m_Layouts{};
 
-		using MipLevels = std::vector<VkImageLayout>;
-		using Layers    = std::vector<MipLevels>;
-		VkImage            m_Image{};
-		Layers             m_Layouts{};
 		VmaAllocation      m_Allocation{};
+		bool               m_OwnsAllocation{ true };
 		VkExtent2D         m_Extent{};
 		VkFormat           m_Format{};
 		VkImageAspectFlags m_AspectFlags{};
 		uint32_t           m_Layers{};
 		uint32_t           m_MipLevels{};
+
+		uint64_t m_EmittedBarriers{};
+		uint64_t m_PerSubresourceBarriers{};
+
+		// kept to recreate the image when its memory is relocated
+		VkImageUsageFlags  m_Usage{};
+		VkImageTiling      m_Tiling{ VK_IMAGE_TILING_OPTIMAL };
+		VkImageType        m_Type{};
+		VkImageCreateFlags m_CreateFlags{};
+		VkSharingMode      m_SharingMode{ VK_SHARING_MODE_EXCLUSIVE };
+
+		// null for swapchain images
+		MemoryStats* m_MemoryStats{};
+
+		// whole image granularity, see BarrierBatch::Require
+		ResourceState m_State{};
+
+		// shared with the deleter pushed by the builder
+		std::shared_ptr<ImageViewCache> m_Views{ std::make_shared<ImageViewCache>() };
 	};
 
 	class ImageBuilder final
@@ -158,10 +269,26 @@ namespace vkc
 		ImageBuilder& SetFlags(VkImageCreateFlags flags);
 		ImageBuilder& SetSharingMode(VkSharingMode sharingMode);
 		ImageBuilder& SetMemoryFlags(VmaAllocationCreateFlags createFlags);
+		ImageBuilder& SetPool(VmaPool pool);
+		ImageBuilder& SetName(std::string name);
+		ImageBuilder& SetCategory(std::string category);
+
+		// KTX2 or DDS file used by BuildStreamed
+		ImageBuilder& SetFileName(std::filesystem::path const& fileName);
 
 		[[nodiscard]] Image Build(VkImageUsageFlags usage, bool addToQueue = true) const;
 
+		// image without memory, bind it with Image::BindMemory, memory settings of the builder are ignored
+		[[nodiscard]] Image BuildAliased(VkImageUsageFlags usage, bool addToQueue = true) const;
+
+		// format, extent, mip levels and layers come from the file set with SetFileName, the levels are uploaded
+		// through TextureStream::Stream, TRANSFER_DST usage is added implicitly
+		[[nodiscard]] TextureStream BuildStreamed(VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT, bool addToQueue = true) const;
+
 	private:
+		[[nodiscard]] VkImageCreateInfo MakeCreateInfo(VkImageUsageFlags usage) const;
+		[[nodiscard]] Image MakeImage(VkImageUsageFlags usage) const;
+
 		Context&                 m_Context;
 		VkFormat                 m_Format{ VK_FORMAT_R8G8B8A8_SRGB };
 		VkExtent2D               m_Extent{};
@@ -173,12 +300,15 @@ namespace vkc
 		VmaAllocationCreateFlags m_MemoryFlags{};
 		VkSharingMode            m_SharingMode{ VK_SHARING_MODE_EXCLUSIVE };
 		VmaMemoryUsage           m_MemoryUsage{ VMA_MEMORY_USAGE_AUTO };
+		VmaPool                  m_Pool{};
 		uint32_t                 m_Layers{ 1 };
 		uint32_t                 m_MipLevels{ 1 };
 
 		CommandPool* m_CommandPool{};
 
 		std::string m_FileName;
+		std::string m_Name;
+		std::string m_Category;
 	};
 }
 
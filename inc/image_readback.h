@@ -0,0 +1,86 @@
+#ifndef IMAGE_READBACK_H
+#define IMAGE_READBACK_H
+
+#include "buffer.h"
+
+namespace vkc
+{
+	// copies images into a ring of persistently mapped host buffers and hands the contents out once the copying
+	// submission completed, frames come out in the order they were recorded without waiting on the queue
+	class ImageReadback final
+	{
+	public:
+		struct Frame
+		{
+			void const*  Data{};
+			VkDeviceSize Size{};
+			VkExtent2D   Extent{};
+			VkFormat     Format{};
+
+			// depth is packed the way copies lay it out, e.g. 4 bytes per texel for D24
+			VkImageAspectFlags Aspect{};
+
+			// returned by Record
+			uint64_t Id{};
+		};
+
+		ImageReadback() = delete;
+
+		// every slot has to hold the largest level read back, tightly packed
+		ImageReadback(Context& context, VkDeviceSize slotSize, uint32_t slotCount = 3);
+
+		~ImageReadback() = default;
+
+		ImageReadback(ImageReadback&&)                 = delete;
+		ImageReadback(ImageReadback const&)            = delete;
+		ImageReadback& operator=(ImageReadback&&)      = delete;
+		ImageReadback& operator=(ImageReadback const&) = delete;
+
+		// copies one aspect of one level and layer of an image in TRANSFER_SRC_OPTIMAL into the next slot,
+		// nullopt while every slot still waits for its submission or for Release,
+		// no aspect means the single aspect of the image, depth stencil images need one picked
+		[[nodiscard]] std::optional<uint64_t> Record
+		(
+			Context const&       context
+			, CommandBuffer&     commandBuffer
+			, Image const&       image
+			, uint32_t           mipLevel = 0
+			, uint32_t           layer    = 0
+			, VkImageAspectFlags aspect   = 0
+		);
+
+		// oldest frame once its submission completed, the data stays valid until Release
+		[[nodiscard]] std::optional<Frame> Poll(Context const& context);
+
+		// hands the slot of the oldest frame back to Record
+		void Release();
+
+		[[nodiscard]] uint32_t GetSlotCount() const
+		{
+			return static_cast<uint32_t>(m_Slots.size());
+		}
+
+	private:
+		struct Slot
+		{
+			Buffer             Storage;
+			CommandBuffer*     Owner{};
+			uint64_t           Submission{};
+			VkDeviceSize       Size{};
+			VkExtent2D         Extent{};
+			VkFormat           Format{};
+			VkImageAspectFlags Aspect{};
+		};
+
+		// bytes per texel of the aspect in buffer copies, 0 for block compressed formats
+		[[nodiscard]] static VkDeviceSize GetTexelSize(VkFormat format, VkImageAspectFlags aspect);
+
+		std::vector<Slot> m_Slots;
+
+		// ids are recorded and released in order, the slot of an id is id % slot count
+		uint64_t m_Recorded{};
+		uint64_t m_Released{};
+	};
+}
+
+#endif //IMAGE_READBACK_H
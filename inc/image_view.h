@@ -1,5 +1,7 @@
 #ifndef IMAGE_VIEW_H
 #define IMAGE_VIEW_H
+#include <unordered_map>
+
 #include "context.h"
 
 namespace vkc
@@ -55,6 +57,7 @@ namespace vkc
 
 	private:
 		friend class Image;
+		friend class ImageViewCache;
 		ImageView() = default;
 
 		VkImageView     m_ImageView{};
@@ -64,6 +67,90 @@ namespace vkc
 		uint32_t        m_LayerCount{};
 		uint32_t        m_MipLevelCount{};
 	};
+
+	// undefined format means the format of the image, identity swizzle by default
+	struct ImageViewDescription
+	{
+		VkImageViewType    Type{ VK_IMAGE_VIEW_TYPE_2D };
+		uint32_t           BaseLayer{ 0 };
+		uint32_t           LayerCount{ 1 };
+		uint32_t           BaseMipLevel{ 0 };
+		uint32_t           LevelCount{ 1 };
+		VkFormat           Format{ VK_FORMAT_UNDEFINED };
+		VkComponentMapping Swizzle{};
+
+		[[nodiscard]] bool operator==(ImageViewDescription const& other) const
+		{
+			return Type == other.Type && BaseLayer == other.BaseLayer && LayerCount == other.LayerCount
+				&& BaseMipLevel == other.BaseMipLevel && LevelCount == other.LevelCount && Format == other.Format
+				&& Swizzle.r == other.Swizzle.r && Swizzle.g == other.Swizzle.g
+				&& Swizzle.b == other.Swizzle.b && Swizzle.a == other.Swizzle.a;
+		}
+	};
+
+	// views of a single image, they live until the image is destroyed
+	class ImageViewCache final
+	{
+	public:
+		ImageViewCache() = default;
+
+		~ImageViewCache() = default;
+
+		ImageViewCache(ImageViewCache&&)                 = default;
+		ImageViewCache(ImageViewCache const&)            = delete;
+		ImageViewCache& operator=(ImageViewCache&&)      = default;
+		ImageViewCache& operator=(ImageViewCache const&) = delete;
+
+		[[nodiscard]] ImageView const* Find(ImageViewDescription const& description) const
+		{
+			auto const view = m_Views.find(description);
+			return view != m_Views.end() ? &view->second : nullptr;
+		}
+
+		ImageView const& Insert(ImageViewDescription const& description, ImageView&& view)
+		{
+			return m_Views.emplace(description, std::move(view)).first->second;
+		}
+
+		// hands the handles over without destroying them, e.g. when they have to outlive in-flight work
+		void Release(std::vector<VkImageView>& views)
+		{
+			for (auto const& [description, view]: m_Views)
+				views.push_back(view);
+			m_Views.clear();
+		}
+
+		void Destroy(Context const& context)
+		{
+			for (auto const& [description, view]: m_Views)
+				view.Destroy(context);
+			m_Views.clear();
+		}
+
+		[[nodiscard]] size_t GetSize() const
+		{
+			return m_Views.size();
+		}
+
+	private:
+		struct Hash
+		{
+			[[nodiscard]] size_t operator()(ImageViewDescription const& description) const
+			{
+				uint64_t const range{
+					static_cast<uint64_t>(description.BaseLayer) << 48 ^ static_cast<uint64_t>(description.LayerCount) << 32
+					^ static_cast<uint64_t>(description.BaseMipLevel) << 16 ^ description.LevelCount
+				};
+				uint64_t const format{
+					static_cast<uint64_t>(description.Format) << 32 ^ static_cast<uint64_t>(description.Type) << 24
+					^ description.Swizzle.r << 18 ^ description.Swizzle.g << 12 ^ description.Swizzle.b << 6 ^ description.Swizzle.a
+				};
+				return std::hash<uint64_t>{}(range ^ format * 0x9E3779B97F4A7C15ull);
+			}
+		};
+
+		std::unordered_map<ImageViewDescription, ImageView, Hash> m_Views;
+	};
 }
 
 #endif //IMAGE_VIEW_H
@@ -0,0 +1,51 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+#include <cstddef>
+#include <filesystem>
+
+namespace vkc
+{
+	// read only memory mapping of a whole file, unmapped on destruction
+	class MappedFile final
+	{
+	public:
+		MappedFile() = delete;
+
+		explicit MappedFile(std::filesystem::path const& path);
+
+		~MappedFile();
+
+		MappedFile(MappedFile&&)                 = delete;
+		MappedFile(MappedFile const&)            = delete;
+		MappedFile& operator=(MappedFile&&)      = delete;
+		MappedFile& operator=(MappedFile const&) = delete;
+
+		[[nodiscard]] void const* GetData() const
+		{
+			return m_Data;
+		}
+
+		[[nodiscard]] size_t GetSize() const
+		{
+			return m_Size;
+		}
+
+		// size rounded up to whole pages, bytes past the end of the file read as zero
+		[[nodiscard]] size_t GetMappedSize() const
+		{
+			return (m_Size + GetPageSize() - 1) / GetPageSize() * GetPageSize();
+		}
+
+		[[nodiscard]] static size_t GetPageSize();
+
+	private:
+		void*  m_Data{};
+		size_t m_Size{};
+
+#ifdef _WIN32
+		void* m_Mapping{};
+#endif
+	};
+}
+
+#endif //MAPPED_FILE_H
@@ -0,0 +1,89 @@
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+#include "context.h"
+
+namespace vkc
+{
+	// custom VMA pool to keep allocations of one lifetime class out of the default blocks
+	class MemoryPool final
+	{
+	public:
+		~MemoryPool() = default;
+
+		MemoryPool(MemoryPool&&)                 = default;
+		MemoryPool(MemoryPool const&)            = delete;
+		MemoryPool& operator=(MemoryPool&&)      = default;
+		MemoryPool& operator=(MemoryPool const&) = delete;
+
+		void Destroy(Context const& context) const;
+
+		[[nodiscard]] uint32_t GetMemoryTypeIndex() const
+		{
+			return m_MemoryTypeIndex;
+		}
+
+		operator VmaPool() const
+		{
+			return m_Pool;
+		}
+
+	private:
+		friend class MemoryPoolBuilder;
+		MemoryPool() = default;
+
+		VmaPool  m_Pool{};
+		uint32_t m_MemoryTypeIndex{};
+	};
+
+	class MemoryPoolBuilder final
+	{
+	public:
+		MemoryPoolBuilder() = delete;
+
+		MemoryPoolBuilder(Context& context);
+
+		~MemoryPoolBuilder() = default;
+
+		MemoryPoolBuilder(MemoryPoolBuilder&&)                 = delete;
+		MemoryPoolBuilder(MemoryPoolBuilder const&)            = delete;
+		MemoryPoolBuilder& operator=(MemoryPoolBuilder&&)      = delete;
+		MemoryPoolBuilder& operator=(MemoryPoolBuilder const&) = delete;
+
+		MemoryPoolBuilder& SetMemoryUsage(VmaMemoryUsage memoryUsage);
+
+		MemoryPoolBuilder& SetRequiredMemoryFlags(VkMemoryPropertyFlags flags);
+
+		MemoryPoolBuilder& SetAllocationFlags(VmaAllocationCreateFlags flags);
+
+		// 0 lets VMA pick the block size
+		MemoryPoolBuilder& SetBlockSize(VkDeviceSize blockSize);
+
+		// equal min and max block counts preallocate a fixed budget, e.g. for texture streaming
+		MemoryPoolBuilder& SetBlockCount(size_t minBlockCount, size_t maxBlockCount = 0);
+
+		// stack or, with a single block, ring buffer allocation for per frame transients
+		MemoryPoolBuilder& UseLinearAlgorithm(bool enable = true);
+
+		// memory type is chosen for buffers like the given one, allocations of other buffer kinds may not fit
+		[[nodiscard]] MemoryPool BuildForBuffers(VkBufferUsageFlags usage, bool addToQueue = true) const;
+
+		// memory type is chosen for images like the given one, allocations of other image kinds may not fit
+		[[nodiscard]] MemoryPool BuildForImages
+		(
+			VkImageUsageFlags usage
+			, VkFormat        format     = VK_FORMAT_R8G8B8A8_SRGB
+			, VkImageTiling   tiling     = VK_IMAGE_TILING_OPTIMAL
+			, bool            addToQueue = true
+		) const;
+
+	private:
+		[[nodiscard]] MemoryPool Build(uint32_t memoryTypeIndex, bool addToQueue) const;
+
+		Context&                m_Context;
+		VmaAllocationCreateInfo m_AllocationCreateInfo{};
+		VmaPoolCreateInfo       m_PoolCreateInfo{};
+	};
+}
+
+#endif //MEMORY_POOL_H
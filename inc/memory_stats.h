@@ -0,0 +1,69 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "vma_usage.h"
+
+namespace vkc
+{
+	// live bytes per user supplied category next to VMA's per heap budgets,
+	// budgets are exact only if the allocator was created with VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT
+	// on a device with VK_EXT_memory_budget enabled, otherwise VMA estimates them
+	class MemoryStats final
+	{
+	public:
+		struct HeapBudget
+		{
+			VkDeviceSize      Usage{};
+			VkDeviceSize      Budget{};
+			VkDeviceSize      AllocationBytes{};
+			VkDeviceSize      BlockBytes{};
+			uint32_t          AllocationCount{};
+			VkMemoryHeapFlags Flags{};
+		};
+
+		static constexpr char const* DefaultCategory{ "uncategorized" };
+
+		MemoryStats() = default;
+
+		~MemoryStats() = default;
+
+		MemoryStats(MemoryStats&&)                 = delete;
+		MemoryStats(MemoryStats const&)            = delete;
+		MemoryStats& operator=(MemoryStats&&)      = delete;
+		MemoryStats& operator=(MemoryStats const&) = delete;
+
+		void Track(VmaAllocator allocator, VmaAllocation allocation, std::string const& category);
+
+		void Untrack(VmaAllocation allocation);
+
+		[[nodiscard]] VkDeviceSize GetCategoryBytes(std::string const& category) const;
+
+		[[nodiscard]] std::unordered_map<std::string, VkDeviceSize> const& GetCategories() const
+		{
+			return m_CategoryBytes;
+		}
+
+		[[nodiscard]] static std::vector<HeapBudget> GetHeapBudgets(VmaAllocator allocator);
+
+		// true if any heap uses more than the given fraction of its budget
+		[[nodiscard]] static bool IsOverBudget(VmaAllocator allocator, float threshold = 0.9f);
+
+		// categories, heap budgets and the full vmaBuildStatsString output under "vma"
+		[[nodiscard]] std::string DumpJson(VmaAllocator allocator, bool detailedMap = false) const;
+
+	private:
+		struct Entry
+		{
+			std::string  Category;
+			VkDeviceSize Size;
+		};
+
+		std::unordered_map<VmaAllocation, Entry>      m_Allocations;
+		std::unordered_map<std::string, VkDeviceSize> m_CategoryBytes;
+	};
+}
+
+#endif //MEMORY_STATS_H
@@ -0,0 +1,75 @@
+#ifndef OFFSCREEN_SWAPCHAIN_H
+#define OFFSCREEN_SWAPCHAIN_H
+
+#include "image.h"
+
+namespace vkc
+{
+	// stands in for vkb::Swapchain without a surface, images are handed out in rotation and reused once the submission
+	// that presented them completed, render into them like swapchain images but end in a layout other than PRESENT_SRC_KHR
+	class OffscreenSwapchain final
+	{
+	public:
+		OffscreenSwapchain() = delete;
+
+		OffscreenSwapchain
+		(
+			Context&            context
+			, uint32_t          imageCount
+			, VkExtent2D        extent
+			, VkFormat          format = VK_FORMAT_R8G8B8A8_SRGB
+			, VkImageUsageFlags usage  = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+		);
+
+		~OffscreenSwapchain() = default;
+
+		OffscreenSwapchain(OffscreenSwapchain&&)                 = delete;
+		OffscreenSwapchain(OffscreenSwapchain const&)            = delete;
+		OffscreenSwapchain& operator=(OffscreenSwapchain&&)      = delete;
+		OffscreenSwapchain& operator=(OffscreenSwapchain const&) = delete;
+
+		// index of the next image in rotation, nullopt while its previous presentation is still executing
+		[[nodiscard]] std::optional<uint32_t> AcquireNextImage(Context const& context);
+
+		// call after submitting commandBuffer, the image is in use until that submission completes
+		void Present(uint32_t imageIndex, CommandBuffer& commandBuffer);
+
+		[[nodiscard]] Image& GetImage(uint32_t imageIndex)
+		{
+			return m_Images[imageIndex];
+		}
+
+		[[nodiscard]] std::vector<Image>& GetImages()
+		{
+			return m_Images;
+		}
+
+		[[nodiscard]] uint32_t GetImageCount() const
+		{
+			return static_cast<uint32_t>(m_Images.size());
+		}
+
+		[[nodiscard]] VkExtent2D GetExtent() const
+		{
+			return m_Images.front().GetExtent();
+		}
+
+		[[nodiscard]] VkFormat GetFormat() const
+		{
+			return m_Images.front().GetFormat();
+		}
+
+	private:
+		struct InFlight
+		{
+			CommandBuffer* Owner{};
+			uint64_t       Submission{};
+		};
+
+		std::vector<Image>    m_Images;
+		std::vector<InFlight> m_InFlight;
+		uint32_t              m_Next{};
+	};
+}
+
+#endif //OFFSCREEN_SWAPCHAIN_H
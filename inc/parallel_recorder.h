@@ -0,0 +1,83 @@
+#ifndef PARALLEL_RECORDER_H
+#define PARALLEL_RECORDER_H
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "command_pool.h"
+
+namespace vkc
+{
+	// splits the recording of a dynamic rendering instance over persistent worker threads, every worker records
+	// its share of the tasks into a secondary buffer from its own pool, the primary executes them in worker order
+	class ParallelRecorder final
+	{
+	public:
+		// records task index taskIndex into a secondary buffer that continues the rendering instance of the primary
+		using RecordFunction = std::function<void(Context const&, VkCommandBuffer, uint32_t taskIndex)>;
+
+		ParallelRecorder() = delete;
+
+		// one pool per worker per frame in flight, a pool is only reset when its frame comes around again
+		ParallelRecorder(Context& context, uint32_t queueIndex, uint32_t workerCount, uint32_t framesInFlight);
+
+		~ParallelRecorder() = default;
+
+		ParallelRecorder(ParallelRecorder&&)                 = delete;
+		ParallelRecorder(ParallelRecorder const&)            = delete;
+		ParallelRecorder& operator=(ParallelRecorder&&)      = delete;
+		ParallelRecorder& operator=(ParallelRecorder const&) = delete;
+
+		// resets the pools of the frame before the first Record of that frame,
+		// the previous submission of the frame must have completed
+		void BeginFrame(Context const& context, uint32_t frame);
+
+		// has to be called between cmdBeginRendering with VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT
+		// and cmdEndRendering on the primary, blocks until all tasks are recorded, exceptions of workers are rethrown
+		void Record
+		(
+			Context&                                          context
+			, VkCommandBuffer                                 primary
+			, VkCommandBufferInheritanceRenderingInfo const& renderingInfo
+			, uint32_t                                        taskCount
+			, RecordFunction const&                           record
+		);
+
+		[[nodiscard]] uint32_t GetWorkerCount() const
+		{
+			return static_cast<uint32_t>(m_Workers.size());
+		}
+
+	private:
+		void Work(std::stop_token const& stopToken, uint32_t worker);
+
+		// indexed by frame * worker count + worker, deque since pools can't be moved
+		std::deque<CommandPool> m_Pools;
+		uint32_t                m_Frame{};
+
+		// secondaries of the current job, allocated on the calling thread since allocation touches the deletion queue
+		std::vector<CommandBuffer*>     m_Secondaries;
+		std::vector<std::exception_ptr> m_Errors;
+
+		// current job, only read by workers between the start and the completion of a generation
+		Context const*                                 m_Context{};
+		VkCommandBufferInheritanceRenderingInfo const* m_RenderingInfo{};
+		RecordFunction const*                          m_Record{};
+		uint32_t                                       m_TaskCount{};
+		uint32_t                                       m_ActiveWorkers{};
+
+		std::mutex                  m_Mutex;
+		std::condition_variable_any m_Start;
+		std::condition_variable     m_Done;
+		uint64_t                    m_Generation{};
+		uint32_t                    m_Remaining{};
+
+		// last so workers are stopped and joined before the state they use is destroyed,
+		// stop requests wake them through the stop token
+		std::vector<std::jthread> m_Workers;
+	};
+}
+
+#endif //PARALLEL_RECORDER_H
@@ -0,0 +1,193 @@
+#ifndef RENDER_GRAPH_H
+#define RENDER_GRAPH_H
+#include <deque>
+#include <functional>
+
+#include "barrier_batch.h"
+#include "transient_allocator.h"
+
+namespace vkc
+{
+	// passes declare the accesses of their resources, the graph orders them, drops passes nobody consumes,
+	// batches the barriers of independent passes and lets transient resources share memory when their lifetimes don't overlap
+	class RenderGraph final
+	{
+	public:
+		struct ImageHandle
+		{
+			uint32_t Index{};
+		};
+
+		struct BufferHandle
+		{
+			uint32_t Index{};
+		};
+
+		// images created by the graph, only alive between their first and last use within an execution
+		struct ImageDescription
+		{
+			VkFormat           Format{ VK_FORMAT_R8G8B8A8_UNORM };
+			VkExtent2D         Extent{};
+			VkImageAspectFlags AspectFlags{ VK_IMAGE_ASPECT_COLOR_BIT };
+			uint32_t           Layers{ 1 };
+			uint32_t           MipLevels{ 1 };
+
+			// on top of the usage derived from the declared accesses
+			VkImageUsageFlags Usage{};
+		};
+
+		struct BufferDescription
+		{
+			VkDeviceSize Size{};
+
+			// on top of the usage derived from the declared accesses
+			VkBufferUsageFlags Usage{};
+		};
+
+		using RecordFunction = std::function<void(Context const&, VkCommandBuffer, RenderGraph&)>;
+
+		class Pass final
+		{
+		public:
+			~Pass() = default;
+
+			Pass(Pass&&)                 = default;
+			Pass(Pass const&)            = delete;
+			Pass& operator=(Pass&&)      = default;
+			Pass& operator=(Pass const&) = delete;
+
+			// accesses of the same resource within a pass are merged and must agree on the layout
+			Pass& Read(ImageHandle image, Access const& access);
+			Pass& Write(ImageHandle image, Access const& access);
+			Pass& Read(BufferHandle buffer, Access const& access);
+			Pass& Write(BufferHandle buffer, Access const& access);
+
+			// kept even when nothing consumes its writes, e.g. presentation or readbacks
+			Pass& SetSideEffects(bool sideEffects = true);
+
+			// called during RenderGraph::Execute after the barriers of the pass are recorded
+			Pass& SetRecord(RecordFunction record);
+
+			[[nodiscard]] std::string const& GetName() const
+			{
+				return m_Name;
+			}
+
+			// valid after RenderGraph::Compile
+			[[nodiscard]] bool IsCulled() const
+			{
+				return m_Culled;
+			}
+
+		private:
+			friend class RenderGraph;
+
+			explicit Pass(std::string name)
+				: m_Name{ std::move(name) } {}
+
+			struct ResourceUse
+			{
+				uint32_t    Resource{};
+				bool        IsImage{};
+				bool        IsRead{};
+				bool        IsWrite{};
+				vkc::Access Access{};
+			};
+
+			Pass& Use(uint32_t resource, bool isImage, bool isWrite, Access const& access);
+
+			std::string              m_Name;
+			std::vector<ResourceUse> m_Uses;
+			RecordFunction           m_Record;
+			bool                     m_SideEffects{ false };
+			bool                     m_Culled{ false };
+		};
+
+		RenderGraph() = default;
+
+		~RenderGraph() = default;
+
+		RenderGraph(RenderGraph&&)                 = default;
+		RenderGraph(RenderGraph const&)            = delete;
+		RenderGraph& operator=(RenderGraph&&)      = default;
+		RenderGraph& operator=(RenderGraph const&) = delete;
+
+		// imported resources outlive the graph, writes to them count as outputs and keep the writing passes alive
+		[[nodiscard]] ImageHandle ImportImage(Image& image);
+		[[nodiscard]] BufferHandle ImportBuffer(Buffer& buffer);
+
+		[[nodiscard]] ImageHandle CreateImage(ImageDescription const& description);
+		[[nodiscard]] BufferHandle CreateBuffer(BufferDescription const& description);
+
+		// the reference stays valid while passes are added
+		Pass& AddPass(std::string name);
+
+		// culls, orders and groups the passes, then creates the transient resources and aliases their memory,
+		// the graph is fixed afterwards
+		void Compile(Context& context, bool addToQueue = true);
+
+		// records barriers and passes, may be repeated every frame as long as executions don't overlap on the GPU
+		void Execute(Context const& context, VkCommandBuffer commandBuffer);
+
+		// transient resources and their memory, only for graphs compiled without addToQueue
+		void Destroy(Context const& context) const;
+
+		[[nodiscard]] Image& GetImage(ImageHandle image);
+
+		[[nodiscard]] Buffer& GetBuffer(BufferHandle buffer);
+
+		// memory backing all transient resources after aliasing
+		[[nodiscard]] VkDeviceSize GetTransientMemorySize() const
+		{
+			return m_Allocator.GetAllocatedSize();
+		}
+
+	private:
+		// steps are indices into m_Steps, transient resources are only created when a pass survives culling
+		struct ImageResource
+		{
+			Image*            Imported{};
+			ImageDescription  Description{};
+			VkImageUsageFlags Usage{};
+			uint32_t          Transient{ NoIndex };
+			uint32_t          Allocation{ NoIndex };
+			uint32_t          FirstStep{ NoIndex };
+			uint32_t          LastStep{};
+		};
+
+		struct BufferResource
+		{
+			Buffer*            Imported{};
+			BufferDescription  Description{};
+			VkBufferUsageFlags Usage{};
+			uint32_t           Transient{ NoIndex };
+			uint32_t           Allocation{ NoIndex };
+			uint32_t           FirstStep{ NoIndex };
+			uint32_t           LastStep{};
+		};
+
+		static constexpr uint32_t NoIndex{ UINT32_MAX };
+
+		[[nodiscard]] static VkImageUsageFlags GetImageUsage(Access const& access);
+		[[nodiscard]] static VkBufferUsageFlags GetBufferUsage(Access const& access);
+
+		void CullAndOrder();
+		void CreateTransientResources(Context& context, bool addToQueue);
+
+		// stable references for AddPass
+		std::deque<Pass> m_Passes;
+
+		std::vector<ImageResource>  m_Images;
+		std::vector<BufferResource> m_Buffers;
+		std::vector<Image>          m_TransientImages;
+		std::vector<Buffer>         m_TransientBuffers;
+		TransientAllocator          m_Allocator;
+
+		// passes without dependencies among each other share one barrier batch
+		std::vector<std::vector<uint32_t>> m_Steps;
+
+		bool m_Compiled{ false };
+	};
+}
+
+#endif //RENDER_GRAPH_H
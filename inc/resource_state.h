@@ -0,0 +1,122 @@
+#ifndef RESOURCE_STATE_H
+#define RESOURCE_STATE_H
+#include <optional>
+
+#include "vma_usage.h"
+
+namespace vkc
+{
+	// upcoming use of a resource, layout is ignored for buffers
+	struct Access
+	{
+		VkPipelineStageFlags2 StageMask{};
+		VkAccessFlags2        AccessMask{};
+		VkImageLayout         Layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+
+		[[nodiscard]] bool IsWrite() const
+		{
+			constexpr VkAccessFlags2 writeMask{
+				VK_ACCESS_2_SHADER_WRITE_BIT
+				| VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT
+				| VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT
+				| VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+				| VK_ACCESS_2_TRANSFER_WRITE_BIT
+				| VK_ACCESS_2_HOST_WRITE_BIT
+				| VK_ACCESS_2_MEMORY_WRITE_BIT
+				| VK_ACCESS_2_TRANSFORM_FEEDBACK_WRITE_BIT_EXT
+				| VK_ACCESS_2_TRANSFORM_FEEDBACK_COUNTER_WRITE_BIT_EXT
+				| VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR
+				| VK_ACCESS_2_COMMAND_PREPROCESS_WRITE_BIT_NV
+			};
+			return AccessMask & writeMask;
+		}
+	};
+
+	// last writer and the readers synchronized with it since, decides whether the next access is a hazard
+	class ResourceState final
+	{
+	public:
+		// source half of the barrier the next access needs
+		struct Dependency
+		{
+			VkPipelineStageFlags2 SrcStageMask{};
+			VkAccessFlags2        SrcAccessMask{};
+		};
+
+		// layout transitions count as writes, read after read and repeated reads already made visible need nothing
+		[[nodiscard]] std::optional<Dependency> Use(Access const& next, bool layoutChange = false)
+		{
+			if (next.IsWrite() || layoutChange)
+			{
+				// write after write needs availability, write after read only an execution dependency
+				Dependency const dependency{ m_WriteStages | m_ReadStages, m_WriteAccess };
+				Synchronize(next);
+
+				// first use of a resource without a layout change has nothing to wait for
+				if (dependency.SrcStageMask == 0 && !layoutChange)
+					return std::nullopt;
+				return dependency;
+			}
+
+			if (m_WriteStages == 0)
+			{
+				m_ReadStages |= next.StageMask;
+				return std::nullopt;
+			}
+
+			// earlier barrier already made the write visible to these stages and accesses
+			if ((next.StageMask & ~m_ReadStages) == 0 && (next.AccessMask & ~m_ReadAccess) == 0)
+				return std::nullopt;
+
+			m_ReadStages |= next.StageMask;
+			m_ReadAccess |= next.AccessMask;
+			return Dependency{ m_WriteStages, m_WriteAccess };
+		}
+
+		// state right after a barrier recorded elsewhere whose destination scope was access
+		void Synchronize(Access const& access)
+		{
+			bool const isWrite{ access.IsWrite() };
+			m_WriteStages = access.StageMask;
+			m_WriteAccess = access.AccessMask & ~ReadOnlyMask(access.AccessMask);
+			m_ReadStages  = isWrite ? VkPipelineStageFlags2{} : access.StageMask;
+			m_ReadAccess  = isWrite ? VkAccessFlags2{} : access.AccessMask;
+		}
+
+		// accesses of both have to be waited for, e.g. for resources sharing memory
+		void Merge(ResourceState const& other)
+		{
+			m_WriteStages |= other.m_WriteStages;
+			m_WriteAccess |= other.m_WriteAccess;
+			m_ReadStages |= other.m_ReadStages;
+			m_ReadAccess |= other.m_ReadAccess;
+		}
+
+		// e.g. after a queue submission boundary that synchronized everything
+		void Reset()
+		{
+			*this = {};
+		}
+
+	private:
+		// read bits that may be combined with writes in one access mask
+		[[nodiscard]] static VkAccessFlags2 ReadOnlyMask(VkAccessFlags2 accessMask)
+		{
+			return accessMask & (VK_ACCESS_2_SHADER_READ_BIT
+								 | VK_ACCESS_2_SHADER_SAMPLED_READ_BIT
+								 | VK_ACCESS_2_SHADER_STORAGE_READ_BIT
+								 | VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT
+								 | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+								 | VK_ACCESS_2_TRANSFER_READ_BIT
+								 | VK_ACCESS_2_HOST_READ_BIT
+								 | VK_ACCESS_2_MEMORY_READ_BIT);
+		}
+
+		VkPipelineStageFlags2 m_WriteStages{};
+		VkAccessFlags2        m_WriteAccess{};
+		VkPipelineStageFlags2 m_ReadStages{};
+		VkAccessFlags2        m_ReadAccess{};
+	};
+}
+
+#endif //RESOURCE_STATE_H
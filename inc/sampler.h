@@ -0,0 +1,130 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+#include <unordered_map>
+
+#include "context.h"
+
+namespace vkc
+{
+	class Sampler final
+	{
+	public:
+		~Sampler() = default;
+
+		Sampler(Sampler&&)                 = default;
+		Sampler(Sampler const&)            = delete;
+		Sampler& operator=(Sampler&&)      = default;
+		Sampler& operator=(Sampler const&) = delete;
+
+		// does nothing for samplers shared through a SamplerCache
+		void Destroy(Context const& context) const;
+
+		[[nodiscard]] bool IsCached() const
+		{
+			return m_Cached;
+		}
+
+		operator VkSampler() const
+		{
+			return m_Sampler;
+		}
+
+		operator VkSampler const*() const
+		{
+			return &m_Sampler;
+		}
+
+	private:
+		friend class SamplerBuilder;
+		Sampler() = default;
+
+		VkSampler m_Sampler{};
+		bool      m_Cached{ false };
+	};
+
+	// one sampler per distinct create info, handed out to every builder using the cache until the cache is destroyed
+	class SamplerCache final
+	{
+	public:
+		SamplerCache() = default;
+
+		~SamplerCache() = default;
+
+		SamplerCache(SamplerCache&&)                 = delete;
+		SamplerCache(SamplerCache const&)            = delete;
+		SamplerCache& operator=(SamplerCache&&)      = delete;
+		SamplerCache& operator=(SamplerCache const&) = delete;
+
+		void Destroy(Context const& context);
+
+		[[nodiscard]] size_t GetSize() const
+		{
+			return m_Samplers.size();
+		}
+
+	private:
+		friend class SamplerBuilder;
+
+		// the create info without its chain, the only chained state is the reduction mode
+		struct Key
+		{
+			VkSamplerCreateInfo    CreateInfo{};
+			VkSamplerReductionMode ReductionMode{};
+
+			[[nodiscard]] bool operator==(Key const& other) const;
+		};
+
+		struct Hash
+		{
+			[[nodiscard]] size_t operator()(Key const& key) const;
+		};
+
+		std::unordered_map<Key, VkSampler, Hash> m_Samplers;
+	};
+
+	class SamplerBuilder final
+	{
+	public:
+		SamplerBuilder() = delete;
+
+		explicit SamplerBuilder(Context& context);
+
+		~SamplerBuilder() = default;
+
+		SamplerBuilder(SamplerBuilder&&)                 = delete;
+		SamplerBuilder(SamplerBuilder const&)            = delete;
+		SamplerBuilder& operator=(SamplerBuilder&&)      = delete;
+		SamplerBuilder& operator=(SamplerBuilder const&) = delete;
+
+		SamplerBuilder& SetFilter(VkFilter magFilter, VkFilter minFilter);
+		SamplerBuilder& SetMipmapMode(VkSamplerMipmapMode mipmapMode);
+		SamplerBuilder& SetAddressMode(VkSamplerAddressMode u, VkSamplerAddressMode v, VkSamplerAddressMode w);
+		SamplerBuilder& SetAddressMode(VkSamplerAddressMode addressMode);
+		SamplerBuilder& SetLod(float minLod, float maxLod, float mipLodBias = 0.0f);
+		SamplerBuilder& SetBorderColor(VkBorderColor borderColor);
+		SamplerBuilder& SetUnnormalizedCoordinates(bool unnormalized = true);
+
+		// clamped to the device limit, 1 or less disables anisotropic filtering, needs the samplerAnisotropy feature
+		SamplerBuilder& SetAnisotropy(float maxAnisotropy);
+
+		// enables depth comparison
+		SamplerBuilder& SetCompareOp(VkCompareOp compareOp);
+
+		// min and max need the samplerFilterMinmax feature
+		SamplerBuilder& SetReductionMode(VkSamplerReductionMode reductionMode);
+
+		// identical requests return the same handle, owned by the cache
+		SamplerBuilder& UseCache(SamplerCache& cache);
+
+		// addToQueue is ignored for cached samplers
+		[[nodiscard]] Sampler Build(bool addToQueue = true) const;
+
+	private:
+		Context&               m_Context;
+		VkSamplerCreateInfo    m_CreateInfo{};
+		VkSamplerReductionMode m_ReductionMode{ VK_SAMPLER_REDUCTION_MODE_WEIGHTED_AVERAGE };
+		SamplerCache*          m_Cache{};
+	};
+}
+
+#endif //SAMPLER_H
@@ -0,0 +1,113 @@
+#ifndef STAGING_RING_H
+#define STAGING_RING_H
+#include <deque>
+#include <optional>
+
+#include "buffer.h"
+
+namespace vkc
+{
+	// single persistently mapped upload buffer handing out sub-ranges,
+	// space is reclaimed once the command buffer that used it finishes execution
+	class StagingRing final
+	{
+	public:
+		struct Allocation
+		{
+			VkDeviceSize Offset{};
+			VkDeviceSize Size{};
+			void*        Data{};
+		};
+
+		StagingRing() = delete;
+
+		StagingRing(Context& context, VkDeviceSize size);
+
+		~StagingRing() = default;
+
+		StagingRing(StagingRing&&)                 = delete;
+		StagingRing(StagingRing const&)            = delete;
+		StagingRing& operator=(StagingRing&&)      = delete;
+		StagingRing& operator=(StagingRing const&) = delete;
+
+		// range stays reserved until the next submission of the command buffer completes
+		[[nodiscard]] std::optional<Allocation> Allocate
+		(Context const& context, CommandBuffer& commandBuffer, VkDeviceSize size, VkDeviceSize alignment = 16);
+
+		// copies data into the ring and records a copy into dst, returns false if the ring is out of space
+		template<typename DataType>
+		bool Upload
+		(
+			Context const&    context
+			, CommandBuffer&  commandBuffer
+			, DataType const& data
+			, Buffer const&   dst
+			, VkDeviceSize    dstOffset = 0
+		)
+		{
+			void const*  src{};
+			VkDeviceSize size{};
+			if constexpr (!IsContainer<DataType>)
+			{
+				src  = &data;
+				size = sizeof(DataType);
+			}
+			else
+			{
+				src  = data.data();
+				size = data.size() * sizeof(data[0]);
+			}
+
+			if (size == 0)
+				return true;
+
+			std::optional<Allocation> const allocation{ Allocate(context, commandBuffer, size) };
+			if (!allocation)
+				return false;
+
+			memcpy(allocation->Data, src, size);
+			CopyTo(context, commandBuffer, *allocation, dst, dstOffset);
+			return true;
+		}
+
+		void CopyTo
+		(
+			Context const&         context
+			, CommandBuffer const& commandBuffer
+			, Allocation const&    allocation
+			, Buffer const&        dst
+			, VkDeviceSize         dstOffset = 0
+		) const;
+
+		// releases ranges of all completed submissions, called implicitly when the ring runs out of space
+		void Reclaim(Context const& context);
+
+		[[nodiscard]] Buffer const& GetBuffer() const
+		{
+			return m_Buffer;
+		}
+
+		[[nodiscard]] VkDeviceSize GetCapacity() const
+		{
+			return m_Buffer.GetSize();
+		}
+
+	private:
+		[[nodiscard]] std::optional<VkDeviceSize> FindSpace(VkDeviceSize size, VkDeviceSize alignment) const;
+
+		struct InFlightRange
+		{
+			CommandBuffer* Owner;
+			uint64_t       Submission;
+			VkDeviceSize   End;
+		};
+
+		Buffer       m_Buffer;
+		VkDeviceSize m_Head{};
+		VkDeviceSize m_Tail{};
+
+		std::deque<InFlightRange> m_InFlight;
+	};
+}
+
+#endif //STAGING_RING_H
@@ -0,0 +1,12 @@
+#ifndef STREAMING_COPY_H
+#define STREAMING_COPY_H
+#include <cstddef>
+
+namespace vkc
+{
+	// memcpy replacement using non-temporal stores, meant for write-combined mapped memory (BAR, uncached upload heaps)
+	// uses AVX2 when the CPU supports it, SSE2 on any other x86-64 CPU and plain memcpy elsewhere
+	void StreamingCopy(void* dst, void const* src, size_t size);
+}
+
+#endif //STREAMING_COPY_H
@@ -0,0 +1,100 @@
+#ifndef TEXTURE_FILE_H
+#define TEXTURE_FILE_H
+#include <memory>
+#include <vector>
+
+#include "mapped_file.h"
+#include "vma_usage.h"
+
+namespace vkc
+{
+	// KTX2 or DDS texture parsed in place from a memory mapped file, supercompressed KTX2 and volume textures are rejected
+	class TextureFile final
+	{
+	public:
+		// layers are not necessarily contiguous in the file, DDS stores all levels of a layer together
+		struct Level
+		{
+			VkDeviceSize        LayerSize{};
+			std::vector<size_t> LayerOffsets;
+		};
+
+		TextureFile() = delete;
+
+		explicit TextureFile(std::filesystem::path const& path);
+
+		~TextureFile() = default;
+
+		TextureFile(TextureFile&&)                 = default;
+		TextureFile(TextureFile const&)            = delete;
+		TextureFile& operator=(TextureFile&&)      = default;
+		TextureFile& operator=(TextureFile const&) = delete;
+
+		[[nodiscard]] VkFormat GetFormat() const
+		{
+			return m_Format;
+		}
+
+		[[nodiscard]] VkExtent2D GetExtent() const
+		{
+			return m_Extent;
+		}
+
+		// cubemap faces count as layers
+		[[nodiscard]] uint32_t GetLayerCount() const
+		{
+			return m_Layers;
+		}
+
+		[[nodiscard]] uint32_t GetMipLevelCount() const
+		{
+			return static_cast<uint32_t>(m_Levels.size());
+		}
+
+		[[nodiscard]] bool IsCubemap() const
+		{
+			return m_Cubemap;
+		}
+
+		// bytes per texel or per compressed block, staging offsets have to be a multiple of it
+		[[nodiscard]] uint32_t GetBlockSize() const
+		{
+			return m_BlockSize;
+		}
+
+		// tightly packed bytes of one layer, throws for formats texture files can't hold
+		[[nodiscard]] static VkDeviceSize CalculateSize(VkFormat format, VkExtent2D extent);
+
+		[[nodiscard]] Level const& GetLevel(uint32_t mipLevel) const
+		{
+			return m_Levels[mipLevel];
+		}
+
+		[[nodiscard]] std::byte const* GetData() const
+		{
+			return static_cast<std::byte const*>(m_File->GetData());
+		}
+
+	private:
+		void ParseKtx2();
+		void ParseDds();
+
+		[[nodiscard]] VkDeviceSize GetLevelLayerSize(uint32_t mipLevel) const;
+
+		// bounds checked read of a little endian value at the given file offset
+		template<typename T>
+		[[nodiscard]] T Read(size_t offset) const;
+
+		std::unique_ptr<MappedFile> m_File;
+
+		VkFormat           m_Format{ VK_FORMAT_UNDEFINED };
+		VkExtent2D         m_Extent{};
+		uint32_t           m_Layers{ 1 };
+		bool               m_Cubemap{ false };
+		uint32_t           m_BlockSize{};
+		bool               m_Compressed{ false };
+		std::vector<Level> m_Levels;
+	};
+}
+
+#endif //TEXTURE_FILE_H
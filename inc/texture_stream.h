@@ -0,0 +1,83 @@
+#ifndef TEXTURE_STREAM_H
+#define TEXTURE_STREAM_H
+
+#include "staging_ring.h"
+#include "texture_file.h"
+
+namespace vkc
+{
+	// image created from a texture file whose levels are uploaded smallest first over several Stream calls,
+	// levels from GetStreamedMipLevel on are in SHADER_READ_ONLY_OPTIMAL and may be sampled, e.g. by clamping the view or min lod
+	class TextureStream final
+	{
+	public:
+		~TextureStream() = default;
+
+		TextureStream(TextureStream&&)                 = default;
+		TextureStream(TextureStream const&)            = delete;
+		TextureStream& operator=(TextureStream&&)      = default;
+		TextureStream& operator=(TextureStream const&) = delete;
+
+		// records uploads of the next levels as long as they fit into the staging ring and the byte budget,
+		// at least one level is uploaded if the ring has space, returns true once every level is resident,
+		// throws when the ring is smaller than GetRequiredStagingSize since the level would never fit
+		bool Stream
+		(
+			Context const&   context
+			, CommandBuffer& commandBuffer
+			, StagingRing&   stagingRing
+			, VkDeviceSize   byteBudget = VK_WHOLE_SIZE
+		);
+
+		// equals the mip level count while nothing is resident yet
+		[[nodiscard]] uint32_t GetStreamedMipLevel() const
+		{
+			return m_StreamedMipLevel;
+		}
+
+		// smallest staging ring capacity that can hold every level, all layers of a level are staged at once
+		[[nodiscard]] VkDeviceSize GetRequiredStagingSize() const
+		{
+			return m_File.GetLevel(0).LayerSize * m_File.GetLayerCount();
+		}
+
+		[[nodiscard]] bool IsComplete() const
+		{
+			return m_StreamedMipLevel == 0;
+		}
+
+		[[nodiscard]] Image& GetImage()
+		{
+			return m_Image;
+		}
+
+		[[nodiscard]] Image const& GetImage() const
+		{
+			return m_Image;
+		}
+
+		[[nodiscard]] TextureFile const& GetFile() const
+		{
+			return m_File;
+		}
+
+		void Destroy(Context const& context) const
+		{
+			m_Image.Destroy(context);
+		}
+
+	private:
+		friend class ImageBuilder;
+
+		TextureStream(TextureFile&& file, Image&& image)
+			: m_File{ std::move(file) }
+			, m_Image{ std::move(image) }
+			, m_StreamedMipLevel{ m_File.GetMipLevelCount() } {}
+
+		TextureFile m_File;
+		Image       m_Image;
+		uint32_t    m_StreamedMipLevel;
+	};
+}
+
+#endif //TEXTURE_STREAM_H
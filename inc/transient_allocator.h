@@ -0,0 +1,92 @@
+#ifndef TRANSIENT_ALLOCATOR_H
+#define TRANSIENT_ALLOCATOR_H
+#include <variant>
+
+#include "buffer.h"
+
+namespace vkc
+{
+	// packs images and buffers with declared lifetimes into shared allocations, resources whose lifetimes
+	// don't overlap may occupy the same memory
+	class TransientAllocator final
+	{
+	public:
+		// inclusive, in any unit that orders the uses, e.g. render graph steps
+		struct Lifetime
+		{
+			uint32_t FirstUse{};
+			uint32_t LastUse{};
+		};
+
+		TransientAllocator() = default;
+
+		~TransientAllocator() = default;
+
+		TransientAllocator(TransientAllocator&&)                 = default;
+		TransientAllocator(TransientAllocator const&)            = delete;
+		TransientAllocator& operator=(TransientAllocator&&)      = default;
+		TransientAllocator& operator=(TransientAllocator const&) = delete;
+
+		// resources come from BuildAliased and have to stay at the same address until they are bound,
+		// returns the index used by the getters
+		uint32_t Add(Image& image, Lifetime lifetime);
+		uint32_t Add(Buffer& buffer, Lifetime lifetime);
+
+		// one allocation per compatible set of memory types, every resource is bound at its offset
+		void Allocate(Context& context, bool addToQueue = true);
+
+		// only the allocations, resources are destroyed by whoever built them
+		void Destroy(Context const& context) const;
+
+		// resources whose memory overlaps with the given one
+		[[nodiscard]] std::span<uint32_t const> GetAliases(uint32_t resource) const
+		{
+			return m_Resources[resource].Aliases;
+		}
+
+		// merged state of the resource and its aliases, what Image::Discard or Buffer::Discard has to wait for
+		[[nodiscard]] ResourceState GetAliasedState(uint32_t resource) const;
+
+		[[nodiscard]] VkDeviceSize GetOffset(uint32_t resource) const
+		{
+			return m_Resources[resource].Offset;
+		}
+
+		// memory actually allocated
+		[[nodiscard]] VkDeviceSize GetAllocatedSize() const;
+
+		// memory the resources would need without aliasing
+		[[nodiscard]] VkDeviceSize GetRequestedSize() const;
+
+	private:
+		struct Resource
+		{
+			std::variant<Image*, Buffer*> Target;
+			Lifetime                      Uses{};
+			VkMemoryRequirements          Requirements{};
+
+			// buffers and linear images must not share a granularity page with optimal images
+			bool IsLinear{};
+
+			uint32_t              Block{};
+			VkDeviceSize          Offset{};
+			std::vector<uint32_t> Aliases;
+		};
+
+		struct Block
+		{
+			VmaAllocation        Allocation{};
+			VkMemoryRequirements Requirements{};
+		};
+
+		[[nodiscard]] static ResourceState const& GetState(Resource const& resource);
+
+		void Pack(uint32_t block, VkDeviceSize granularity);
+
+		std::vector<Resource> m_Resources;
+		std::vector<Block>    m_Blocks;
+		MemoryStats*          m_MemoryStats{};
+	};
+}
+
+#endif //TRANSIENT_ALLOCATOR_H
@@ -0,0 +1,110 @@
+#ifndef UPLOAD_ENGINE_H
+#define UPLOAD_ENGINE_H
+
+#include "command_pool.h"
+#include "staging_ring.h"
+
+namespace vkc
+{
+	// records uploads on the transfer queue so they overlap rendering,
+	// graphics submissions wait on the timeline semaphore value returned by Submit
+	class UploadEngine final
+	{
+	public:
+		UploadEngine() = delete;
+
+		// expects Context::DiscoverTransferQueue to have been called
+		UploadEngine(Context& context, VkDeviceSize stagingSize, uint32_t commandBufferCount = 2);
+
+		~UploadEngine() = default;
+
+		UploadEngine(UploadEngine&&)                 = delete;
+		UploadEngine(UploadEngine const&)            = delete;
+		UploadEngine& operator=(UploadEngine&&)      = delete;
+		UploadEngine& operator=(UploadEngine const&) = delete;
+
+		// returns false when the staging memory is exhausted, submit and retry later in that case
+		template<typename DataType>
+		bool Upload
+		(
+			Context&                context
+			, DataType const&       data
+			, Buffer const&         dst
+			, VkDeviceSize          dstOffset
+			, VkPipelineStageFlags2 dstStageMask
+			, VkAccessFlags2        dstAccessMask
+		)
+		{
+			if constexpr (!IsContainer<DataType>)
+				return Upload(context, &data, sizeof(DataType), dst, dstOffset, dstStageMask, dstAccessMask);
+			else
+				return Upload(context, data.data(), data.size() * sizeof(data[0]), dst, dstOffset, dstStageMask, dstAccessMask);
+		}
+
+		bool Upload
+		(
+			Context&                context
+			, void const*           data
+			, VkDeviceSize          size
+			, Buffer const&         dst
+			, VkDeviceSize          dstOffset
+			, VkPipelineStageFlags2 dstStageMask
+			, VkAccessFlags2        dstAccessMask
+		);
+
+		// replaces the contents of mip 0 of every layer, the image ends up in finalLayout
+		bool Upload
+		(
+			Context&                context
+			, void const*           data
+			, VkDeviceSize          size
+			, Image&                dst
+			, VkImageLayout         finalLayout
+			, VkPipelineStageFlags2 dstStageMask
+			, VkAccessFlags2        dstAccessMask
+		);
+
+		// submits everything recorded since the last call, returns the timeline value signaled on completion
+		uint64_t Submit(Context& context);
+
+		// has to be recorded into the graphics command buffer that waits on GetWaitInfo,
+		// completes queue family ownership transfers of submitted uploads
+		void AcquireOwnership(Context const& context, VkCommandBuffer commandBuffer);
+
+		[[nodiscard]] VkSemaphoreSubmitInfo GetWaitInfo(VkPipelineStageFlags2 stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT) const;
+
+		[[nodiscard]] uint64_t GetCompletedValue(Context const& context) const;
+
+		[[nodiscard]] VkSemaphore GetTimelineSemaphore() const
+		{
+			return m_Timeline;
+		}
+
+	private:
+		CommandBuffer& GetCommandBuffer(Context& context);
+
+		[[nodiscard]] bool TransfersOwnership() const
+		{
+			return m_TransferFamily != m_GraphicsFamily;
+		}
+
+		uint32_t m_TransferFamily;
+		uint32_t m_GraphicsFamily;
+
+		CommandPool    m_CommandPool;
+		StagingRing    m_StagingRing;
+		CommandBuffer* m_CommandBuffer{};
+
+		VkSemaphore m_Timeline{};
+		uint64_t    m_TimelineValue{};
+
+		// release side is recorded at submit, acquire side becomes available once submitted
+		std::vector<VkBufferMemoryBarrier2> m_BufferReleases;
+		std::vector<VkBufferMemoryBarrier2> m_PendingBufferAcquires;
+		std::vector<VkImageMemoryBarrier2>  m_PendingImageAcquires;
+		std::vector<VkBufferMemoryBarrier2> m_BufferAcquires;
+		std::vector<VkImageMemoryBarrier2>  m_ImageAcquires;
+	};
+}
+
+#endif //UPLOAD_ENGINE_H
@@ -0,0 +1,97 @@
+#include "barrier_batch.h"
+
+vkc::BarrierBatch& vkc::BarrierBatch::Add(Image& image, Image::Transition const& transition)
+{
+	image.AppendTransition(m_ImageBarriers, transition);
+	image.SynchronizeState(transition);
+	return *this;
+}
+
+vkc::BarrierBatch& vkc::BarrierBatch::Add(Buffer const& buffer, BufferBarrier const& barrier)
+{
+	VkBufferMemoryBarrier2& bufferBarrier = m_BufferBarriers.emplace_back();
+	bufferBarrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+	bufferBarrier.srcStageMask        = barrier.SrcStageMask;
+	bufferBarrier.srcAccessMask       = barrier.SrcAccessMask;
+	bufferBarrier.dstStageMask        = barrier.DstStageMask;
+	bufferBarrier.dstAccessMask       = barrier.DstAccessMask;
+	bufferBarrier.srcQueueFamilyIndex = barrier.SrcQueue;
+	bufferBarrier.dstQueueFamilyIndex = barrier.DstQueue;
+	bufferBarrier.buffer              = buffer;
+	bufferBarrier.offset              = barrier.Offset;
+	bufferBarrier.size                = barrier.Size;
+	return *this;
+}
+
+vkc::BarrierBatch& vkc::BarrierBatch::Require(Image& image, Access const& access)
+{
+	assert(access.Layout != VK_IMAGE_LAYOUT_UNDEFINED);
+
+	Image::Transition transition{};
+	transition.LayerCount = image.GetLayerCount();
+	transition.LevelCount = image.GetMipLevelCount();
+	transition.NewLayout  = access.Layout;
+
+	bool const layoutChange{ !image.HasEqualLayouts(transition) || image.GetLayout() != access.Layout };
+	if (std::optional<ResourceState::Dependency> const dependency{ image.m_State.Use(access, layoutChange) })
+	{
+		transition.SrcStageMask  = dependency->SrcStageMask;
+		transition.SrcAccessMask = dependency->SrcAccessMask;
+		transition.DstStageMask  = access.StageMask;
+		transition.DstAccessMask = access.AccessMask;
+		image.AppendTransition(m_ImageBarriers, transition);
+	}
+	return *this;
+}
+
+vkc::BarrierBatch& vkc::BarrierBatch::Require(Buffer& buffer, Access const& access)
+{
+	if (std::optional<ResourceState::Dependency> const dependency{ buffer.m_State.Use(access) })
+	{
+		BufferBarrier barrier{};
+		barrier.SrcStageMask  = dependency->SrcStageMask;
+		barrier.SrcAccessMask = dependency->SrcAccessMask;
+		barrier.DstStageMask  = access.StageMask;
+		barrier.DstAccessMask = access.AccessMask;
+		Add(buffer, barrier);
+	}
+	return *this;
+}
+
+vkc::BarrierBatch& vkc::BarrierBatch::Add
+(
+	VkPipelineStageFlags2   srcStageMask
+	, VkAccessFlags2        srcAccessMask
+	, VkPipelineStageFlags2 dstStageMask
+	, VkAccessFlags2        dstAccessMask
+)
+{
+	m_MemoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+	m_MemoryBarrier.srcStageMask |= srcStageMask;
+	m_MemoryBarrier.srcAccessMask |= srcAccessMask;
+	m_MemoryBarrier.dstStageMask |= dstStageMask;
+	m_MemoryBarrier.dstAccessMask |= dstAccessMask;
+	m_HasMemoryBarrier = true;
+	return *this;
+}
+
+void vkc::BarrierBatch::Flush(Context const& context, VkCommandBuffer commandBuffer)
+{
+	if (IsEmpty())
+		return;
+
+	VkDependencyInfo dependencyInfo{};
+	dependencyInfo.sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dependencyInfo.memoryBarrierCount       = m_HasMemoryBarrier ? 1 : 0;
+	dependencyInfo.pMemoryBarriers          = &m_MemoryBarrier;
+	dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(m_BufferBarriers.size());
+	dependencyInfo.pBufferMemoryBarriers    = m_BufferBarriers.data();
+	dependencyInfo.imageMemoryBarrierCount  = static_cast<uint32_t>(m_ImageBarriers.size());
+	dependencyInfo.pImageMemoryBarriers     = m_ImageBarriers.data();
+	context.DispatchTable.cmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+
+	m_ImageBarriers.clear();
+	m_BufferBarriers.clear();
+	m_MemoryBarrier    = {};
+	m_HasMemoryBarrier = false;
+}
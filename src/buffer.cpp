@@ -1,5 +1,10 @@
 #include "buffer.h"
 
+#include <algorithm>
+#include <fstream>
+
+#include "streaming_copy.h"
+
 void vkc::Buffer::CopyTo(Context const& context, CommandBuffer const& commandBuffer, Buffer const& dst) const
 {
 	assert(this->GetSize() == dst.GetSize());
@@ -20,6 +25,78 @@ void vkc::Buffer::CopyTo(Context const& context, CommandBuffer const& commandBuf
 	context.DispatchTable.cmdCopyBuffer2(commandBuffer, &info);
 }
 
+void vkc::Buffer::CopyTo(Context const& context, CommandBuffer const& commandBuffer, BufferSlice const& dst) const
+{
+	assert(this->GetSize() <= dst.Size);
+
+	VkBufferCopy2 copyRegion{};
+	copyRegion.sType     = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
+	copyRegion.srcOffset = 0;
+	copyRegion.dstOffset = dst.Offset;
+	copyRegion.size      = this->GetSize();
+
+	VkCopyBufferInfo2 info{};
+	info.sType       = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+	info.srcBuffer   = *this;
+	info.dstBuffer   = dst.Buffer;
+	info.regionCount = 1;
+	info.pRegions    = &copyRegion;
+
+	context.DispatchTable.cmdCopyBuffer2(commandBuffer, &info);
+}
+
+void vkc::Buffer::CopyRegions
+(Context const& context, CommandBuffer const& commandBuffer, Buffer const& dst, std::span<CopyRegion const> regions) const
+{
+	std::vector<CopyRegion> sortedRegions{ regions.begin(), regions.end() };
+	std::ranges::sort(sortedRegions
+					  , [](CopyRegion const& lhs, CopyRegion const& rhs)
+					  {
+						  return lhs.SrcOffset != rhs.SrcOffset ? lhs.SrcOffset < rhs.SrcOffset : lhs.DstOffset < rhs.DstOffset;
+					  });
+
+	std::vector<VkBufferCopy2> copyRegions;
+	copyRegions.reserve(sortedRegions.size());
+	for (CopyRegion const& region: sortedRegions)
+	{
+		assert(region.SrcOffset + region.Size <= GetSize() && region.DstOffset + region.Size <= dst.GetSize());
+		if (region.Size == 0)
+			continue;
+
+		if (!copyRegions.empty())
+		{
+			VkBufferCopy2& last = copyRegions.back();
+
+			bool const sameDistance{ region.DstOffset + last.srcOffset == last.dstOffset + region.SrcOffset };
+			bool const touches{ region.SrcOffset <= last.srcOffset + last.size };
+			if (sameDistance && touches)
+			{
+				last.size = std::max(last.size, region.SrcOffset + region.Size - last.srcOffset);
+				continue;
+			}
+		}
+
+		VkBufferCopy2 copyRegion{};
+		copyRegion.sType     = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
+		copyRegion.srcOffset = region.SrcOffset;
+		copyRegion.dstOffset = region.DstOffset;
+		copyRegion.size      = region.Size;
+		copyRegions.emplace_back(copyRegion);
+	}
+
+	if (copyRegions.empty())
+		return;
+
+	VkCopyBufferInfo2 info{};
+	info.sType       = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+	info.srcBuffer   = *this;
+	info.dstBuffer   = dst;
+	info.regionCount = static_cast<uint32_t>(copyRegions.size());
+	info.pRegions    = copyRegions.data();
+
+	context.DispatchTable.cmdCopyBuffer2(commandBuffer, &info);
+}
+
 void vkc::Buffer::CopyTo(Context const& context, CommandBuffer const& commandBuffer, Image const& dst) const
 {
 	VmaAllocationInfo allocationInfo{};
@@ -48,13 +125,102 @@ void vkc::Buffer::CopyTo(Context const& context, CommandBuffer const& commandBuf
 	context.DispatchTable.cmdCopyBufferToImage2(commandBuffer, &copyImageInfo);
 }
 
+void vkc::Buffer::CopyTo
+(Context const& context, CommandBuffer const& commandBuffer, Image const& dst, std::span<ImageRegion const> regions) const
+{
+	if (regions.empty())
+		return;
+
+	std::vector<VkBufferImageCopy2> copyRegions;
+	copyRegions.reserve(regions.size());
+	for (ImageRegion const& region: regions)
+	{
+		assert(region.BufferOffset < GetSize());
+		assert(region.MipLevel < dst.GetMipLevelCount() && region.BaseLayer + region.LayerCount <= dst.GetLayerCount());
+		assert(dst.GetLayout(region.BaseLayer, region.MipLevel) == dst.GetLayout(regions[0].BaseLayer, regions[0].MipLevel));
+
+		VkExtent2D const extent{
+			region.Extent.width != 0 && region.Extent.height != 0
+			? region.Extent
+			: dst.GetMipExtent(region.MipLevel)
+		};
+
+		VkBufferImageCopy2& copyRegion = copyRegions.emplace_back();
+		copyRegion.sType                           = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2;
+		copyRegion.bufferOffset                    = region.BufferOffset;
+		copyRegion.bufferRowLength                 = region.RowLength;
+		copyRegion.bufferImageHeight               = region.ImageHeight;
+		copyRegion.imageOffset                     = VkOffset3D{ region.Offset.x, region.Offset.y, 0 };
+		copyRegion.imageExtent                     = VkExtent3D{ extent.width, extent.height, 1 };
+		copyRegion.imageSubresource.aspectMask     = dst.GetAspect();
+		copyRegion.imageSubresource.mipLevel       = region.MipLevel;
+		copyRegion.imageSubresource.baseArrayLayer = region.BaseLayer;
+		copyRegion.imageSubresource.layerCount     = region.LayerCount;
+	}
+
+	VkCopyBufferToImageInfo2 copyImageInfo{};
+	copyImageInfo.sType          = VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2;
+	copyImageInfo.dstImage       = dst;
+	copyImageInfo.dstImageLayout = dst.GetLayout(regions[0].BaseLayer, regions[0].MipLevel);
+	copyImageInfo.srcBuffer      = *this;
+	copyImageInfo.regionCount    = static_cast<uint32_t>(copyRegions.size());
+	copyImageInfo.pRegions       = copyRegions.data();
+	context.DispatchTable.cmdCopyBufferToImage2(commandBuffer, &copyImageInfo);
+}
+
 void vkc::Buffer::Destroy(Context const& context) const
 {
+	if (!m_OwnsAllocation)
+	{
+		context.DispatchTable.destroyBuffer(m_Buffer, nullptr);
+		return;
+	}
+
+	if (m_MemoryStats)
+		m_MemoryStats->Untrack(m_Allocation);
+	if (IsImported())
+	{
+		context.DispatchTable.destroyBuffer(m_Buffer, nullptr);
+		context.DispatchTable.freeMemory(m_ImportedMemory, nullptr);
+		return;
+	}
+
+	if (m_FlushQueue)
+		m_FlushQueue->Discard(m_Allocation);
 	if (m_Data)
 		vmaUnmapMemory(context.Allocator, m_Allocation);
 	vmaDestroyBuffer(context.Allocator, *this, m_Allocation);
 }
 
+void vkc::Buffer::Invalidate(Context const& context, VkDeviceSize offset, VkDeviceSize size) const
+{
+	if (vmaInvalidateAllocation(context.Allocator, m_Allocation, offset, size) != VK_SUCCESS)
+		throw std::runtime_error("Failed to invalidate buffer memory");
+}
+
+void vkc::Buffer::BindMemory(Context const& context, VmaAllocation allocation, VkDeviceSize offset)
+{
+	assert(!m_OwnsAllocation);
+
+	if (vmaBindBufferMemory2(context.Allocator, allocation, offset, m_Buffer, nullptr) != VK_SUCCESS)
+		throw std::runtime_error("Failed to bind buffer memory");
+	m_Allocation = allocation;
+}
+
+void vkc::Buffer::WriteMapped(void const* src, VkDeviceSize size, VkDeviceSize offset)
+{
+	assert(m_Data && offset + size <= m_Size);
+
+	void* dst = static_cast<char*>(m_Data) + offset;
+	if (m_StreamingWrites)
+		StreamingCopy(dst, src, size);
+	else
+		memcpy(dst, src, size);
+
+	if (m_FlushQueue)
+		m_FlushQueue->Push(m_Allocation, offset, size);
+}
+
 vkc::Buffer::operator struct VkBuffer_T*() const
 {
 	return m_Buffer;
@@ -85,30 +251,87 @@ vkc::BufferBuilder& vkc::BufferBuilder::SetRequiredMemoryFlags(VkMemoryPropertyF
 	return *this;
 }
 
+vkc::BufferBuilder& vkc::BufferBuilder::SetPreferredMemoryFlags(VkMemoryPropertyFlags flags)
+{
+	m_AllocationCreateInfo.preferredFlags = flags;
+	return *this;
+}
+
 vkc::BufferBuilder& vkc::BufferBuilder::MapMemory(bool map)
 {
 	m_MapMemory = map;
 	return *this;
 }
 
-vkc::Buffer vkc::BufferBuilder::Build(VkBufferUsageFlags usage, VkDeviceSize size, bool addToQueue)
+vkc::BufferBuilder& vkc::BufferBuilder::SetPool(VmaPool pool)
+{
+	m_AllocationCreateInfo.pool = pool;
+	return *this;
+}
+
+vkc::BufferBuilder& vkc::BufferBuilder::UseStreamingWrites(bool enable)
+{
+	m_StreamingWrites = enable;
+	return *this;
+}
+
+vkc::BufferBuilder& vkc::BufferBuilder::SetName(std::string name)
+{
+	m_Name = std::move(name);
+	return *this;
+}
+
+vkc::BufferBuilder& vkc::BufferBuilder::SetCategory(std::string category)
+{
+	m_Category = std::move(category);
+	return *this;
+}
+
+vkc::Buffer vkc::BufferBuilder::Build(VkBufferUsageFlags usage, VkDeviceSize size, bool addToQueue) const
+{
+	return Create(usage, size, m_AllocationCreateInfo, m_MapMemory, addToQueue);
+}
+
+vkc::Buffer vkc::BufferBuilder::Create
+(
+	VkBufferUsageFlags               usage
+	, VkDeviceSize                   size
+	, VmaAllocationCreateInfo const& allocationCreateInfo
+	, bool                           mapMemory
+	, bool                           addToQueue
+) const
 {
 	Buffer buffer{};
-	buffer.m_Size = size;
+	buffer.m_Size        = size;
+	buffer.m_Usage       = usage;
+	buffer.m_SharingMode = m_BufferCreateInfo.sharingMode;
 
-	m_BufferCreateInfo.usage = usage;
-	m_BufferCreateInfo.size  = size;
+	VkBufferCreateInfo bufferCreateInfo{ m_BufferCreateInfo };
+	bufferCreateInfo.usage = usage;
+	bufferCreateInfo.size  = size;
+
+	vmaCreateBuffer(m_Context.Allocator, &bufferCreateInfo, &allocationCreateInfo, buffer, &buffer.m_Allocation, nullptr);
+	if (!m_Name.empty())
+		vmaSetAllocationName(m_Context.Allocator, buffer.m_Allocation, m_Name.c_str());
+	m_Context.MemoryStats.Track(m_Context.Allocator, buffer.m_Allocation, m_Category);
+	buffer.m_MemoryStats = &m_Context.MemoryStats;
 
-	vmaCreateBuffer(m_Context.Allocator, &m_BufferCreateInfo, &m_AllocationCreateInfo, buffer, &buffer.m_Allocation, nullptr);
-	if (m_MapMemory)
+	if (mapMemory)
 		vmaMapMemory(m_Context.Allocator, buffer.m_Allocation, &buffer.m_Data);
 
+	VkMemoryPropertyFlags memoryProperties{};
+	vmaGetAllocationMemoryProperties(m_Context.Allocator, buffer.m_Allocation, &memoryProperties);
+	if ((memoryProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && !(memoryProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+		buffer.m_FlushQueue = &m_Context.FlushQueue;
+	buffer.m_StreamingWrites = m_StreamingWrites && !(memoryProperties & VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+
 	if (addToQueue)
 		m_Context.DeletionQueue.Push([context = &m_Context
 										 , buffer = buffer.m_Buffer
 										 , allocation = buffer.m_Allocation
-										 , mapped = m_MapMemory]
+										 , mapped = mapMemory]
 									 {
+										 context->MemoryStats.Untrack(allocation);
 										 if (mapped)
 											 vmaUnmapMemory(context->Allocator, allocation);
 										 vmaDestroyBuffer(context->Allocator, buffer, allocation);
@@ -116,3 +339,166 @@ vkc::Buffer vkc::BufferBuilder::Build(VkBufferUsageFlags usage, VkDeviceSize siz
 
 	return buffer;
 }
+
+vkc::Buffer vkc::BufferBuilder::BuildAliased(VkBufferUsageFlags usage, VkDeviceSize size, bool addToQueue)
+{
+	Buffer buffer{};
+	buffer.m_Size           = size;
+	buffer.m_Usage          = usage;
+	buffer.m_SharingMode    = m_BufferCreateInfo.sharingMode;
+	buffer.m_OwnsAllocation = false;
+
+	m_BufferCreateInfo.usage = usage;
+	m_BufferCreateInfo.size  = size;
+
+	if (m_Context.DispatchTable.createBuffer(&m_BufferCreateInfo, nullptr, buffer) != VK_SUCCESS)
+		throw std::runtime_error("Failed to create aliased buffer");
+
+	if (addToQueue)
+		m_Context.DeletionQueue.Push([context = &m_Context, buffer = buffer.m_Buffer]
+		{
+			context->DispatchTable.destroyBuffer(buffer, nullptr);
+		});
+	return buffer;
+}
+
+vkc::Buffer vkc::BufferBuilder::BuildFromFile(std::filesystem::path const& path, VkBufferUsageFlags usage, bool addToQueue) const
+{
+	// the file is mapped read only, usages that let the GPU write take the copy path
+	constexpr VkBufferUsageFlags writableUsage{ VK_BUFFER_USAGE_TRANSFER_DST_BIT
+												| VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+												| VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT };
+
+	std::vector<std::string> const extensions{ m_Context.Device.physical_device.get_extensions() };
+	if (!(usage & writableUsage) && std::ranges::find(extensions, VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME) != extensions.end())
+		if (std::optional<Buffer> imported{ TryImport(std::make_shared<MappedFile>(path), usage, addToQueue) })
+			return std::move(*imported);
+
+	// read straight into mapped memory, there is no intermediate copy nor a file sized allocation on the heap
+	std::ifstream file{ path, std::ios::binary };
+	if (!file)
+		throw std::runtime_error("Failed to open file " + path.string());
+
+	VkDeviceSize const size{ std::filesystem::file_size(path) };
+	if (size == 0)
+		throw std::runtime_error("Failed to create buffer from empty file " + path.string());
+
+	VmaAllocationCreateInfo allocationCreateInfo{ m_AllocationCreateInfo };
+	allocationCreateInfo.requiredFlags |= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+	Buffer buffer{ Create(usage, size, allocationCreateInfo, true, addToQueue) };
+
+	constexpr VkDeviceSize chunkSize{ 4 << 20 };
+	for (VkDeviceSize offset{ 0 }; offset < size; offset += chunkSize)
+	{
+		VkDeviceSize const readSize{ std::min(chunkSize, size - offset) };
+		if (!file.read(static_cast<char*>(buffer.m_Data) + offset, static_cast<std::streamsize>(readSize)))
+			throw std::runtime_error("Failed to read file " + path.string());
+	}
+
+	if (buffer.m_FlushQueue)
+		buffer.m_FlushQueue->Push(buffer.m_Allocation, 0, size);
+
+	return buffer;
+}
+
+std::optional<vkc::Buffer> vkc::BufferBuilder::TryImport
+(std::shared_ptr<MappedFile> const& file, VkBufferUsageFlags usage, bool addToQueue) const
+{
+	VkPhysicalDeviceExternalMemoryHostPropertiesEXT hostProperties{};
+	hostProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+
+	VkPhysicalDeviceProperties2 properties{};
+	properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	properties.pNext = &hostProperties;
+	m_Context.InstanceDispatchTable.getPhysicalDeviceProperties2(m_Context.Device.physical_device, &properties);
+
+	// imported range has to be aligned on both ends and must not reach past the pages backing the file
+	VkDeviceSize const alignment{ hostProperties.minImportedHostPointerAlignment };
+	VkDeviceSize const importSize{ (file->GetSize() + alignment - 1) / alignment * alignment };
+	if (reinterpret_cast<uintptr_t>(file->GetData()) % alignment != 0 || importSize > file->GetMappedSize())
+		return std::nullopt;
+
+	void* hostPointer = const_cast<void*>(file->GetData());
+
+	VkMemoryHostPointerPropertiesEXT pointerProperties{};
+	pointerProperties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+	if (m_Context.DispatchTable.getMemoryHostPointerPropertiesEXT(VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT
+																  , hostPointer
+																  , &pointerProperties) != VK_SUCCESS)
+		return std::nullopt;
+
+	VkExternalMemoryBufferCreateInfo externalInfo{};
+	externalInfo.sType       = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+	externalInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
+	VkBufferCreateInfo bufferCreateInfo{ m_BufferCreateInfo };
+	bufferCreateInfo.pNext = &externalInfo;
+	bufferCreateInfo.usage = usage;
+	bufferCreateInfo.size  = file->GetSize();
+
+	Buffer buffer{};
+	buffer.m_Size = file->GetSize();
+	if (m_Context.DispatchTable.createBuffer(&bufferCreateInfo, nullptr, buffer) != VK_SUCCESS)
+		return std::nullopt;
+
+	VkMemoryRequirements requirements{};
+	m_Context.DispatchTable.getBufferMemoryRequirements(buffer, &requirements);
+
+	// lowest compatible type that also has the flags the builder was asked for
+	VkPhysicalDeviceMemoryProperties const& memoryProperties{ m_Context.Device.physical_device.memory_properties };
+	uint32_t const memoryTypeBits{ requirements.memoryTypeBits & pointerProperties.memoryTypeBits };
+	uint32_t       memoryTypeIndex{ VK_MAX_MEMORY_TYPES };
+	for (uint32_t i{ 0 }; i < memoryProperties.memoryTypeCount; ++i)
+	{
+		VkMemoryPropertyFlags const flags{ memoryProperties.memoryTypes[i].propertyFlags };
+		if ((memoryTypeBits & (1u << i)) && (flags & m_AllocationCreateInfo.requiredFlags) == m_AllocationCreateInfo.requiredFlags)
+		{
+			memoryTypeIndex = i;
+			break;
+		}
+	}
+
+	if (memoryTypeIndex == VK_MAX_MEMORY_TYPES || requirements.size > importSize)
+	{
+		m_Context.DispatchTable.destroyBuffer(buffer, nullptr);
+		return std::nullopt;
+	}
+
+	VkImportMemoryHostPointerInfoEXT importInfo{};
+	importInfo.sType        = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+	importInfo.handleType   = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+	importInfo.pHostPointer = hostPointer;
+
+	VkMemoryAllocateInfo allocateInfo{};
+	allocateInfo.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.pNext           = &importInfo;
+	allocateInfo.allocationSize  = importSize;
+	allocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+	if (m_Context.DispatchTable.allocateMemory(&allocateInfo, nullptr, &buffer.m_ImportedMemory) != VK_SUCCESS)
+	{
+		m_Context.DispatchTable.destroyBuffer(buffer, nullptr);
+		return std::nullopt;
+	}
+
+	if (m_Context.DispatchTable.bindBufferMemory(buffer, buffer.m_ImportedMemory, 0) != VK_SUCCESS)
+	{
+		m_Context.DispatchTable.destroyBuffer(buffer, nullptr);
+		m_Context.DispatchTable.freeMemory(buffer.m_ImportedMemory, nullptr);
+		return std::nullopt;
+	}
+
+	buffer.m_MappedFile = file;
+
+	if (addToQueue)
+		m_Context.DeletionQueue.Push([context = &m_Context
+										 , buffer = buffer.m_Buffer
+										 , memory = buffer.m_ImportedMemory
+										 , file]
+									 {
+										 context->DispatchTable.destroyBuffer(buffer, nullptr);
+										 context->DispatchTable.freeMemory(memory, nullptr);
+									 });
+
+	return buffer;
+}
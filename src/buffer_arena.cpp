@@ -0,0 +1,99 @@
+#include "buffer_arena.h"
+
+#include <algorithm>
+
+vkc::BufferArena::BufferArena
+(
+	Context&                     context
+	, VkBufferUsageFlags         usage
+	, VkDeviceSize               blockSize
+	, VkMemoryPropertyFlags      requiredFlags
+	, VmaVirtualBlockCreateFlags algorithm
+)
+	: m_Context{ context }
+	, m_Usage{ usage }
+	, m_BlockSize{ blockSize }
+	, m_RequiredFlags{ requiredFlags }
+	, m_Algorithm{ algorithm }
+{
+	VkPhysicalDeviceLimits const& limits = context.Device.physical_device.properties.limits;
+	if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+		m_MinAlignment = std::max(m_MinAlignment, limits.minUniformBufferOffsetAlignment);
+	if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+		m_MinAlignment = std::max(m_MinAlignment, limits.minStorageBufferOffsetAlignment);
+
+	AddBlock(blockSize);
+}
+
+vkc::BufferSlice vkc::BufferArena::Allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+	VmaVirtualAllocationCreateInfo allocationCreateInfo{};
+	allocationCreateInfo.size      = size;
+	allocationCreateInfo.alignment = std::max(alignment, m_MinAlignment);
+
+	BufferSlice slice{};
+	slice.Size = size;
+
+	auto const tryBlock = [this, &allocationCreateInfo, &slice](uint32_t block)
+	{
+		if (vmaVirtualAllocate(m_Blocks[block].VirtualBlock, &allocationCreateInfo, &slice.Allocation, &slice.Offset) != VK_SUCCESS)
+			return false;
+		slice.Block = block;
+		return true;
+	};
+
+	bool allocated{ false };
+	for (uint32_t block{}; block < m_Blocks.size() && !allocated; ++block)
+		allocated = tryBlock(block);
+
+	if (!allocated)
+	{
+		// oversized requests get a block of their own
+		AddBlock(std::max(m_BlockSize, size));
+		if (!tryBlock(static_cast<uint32_t>(m_Blocks.size() - 1)))
+			throw std::runtime_error("Failed to sub-allocate buffer slice");
+	}
+
+	Buffer const& storage = m_Blocks[slice.Block].Storage;
+	slice.Buffer = storage;
+	if (storage.GetMappedData())
+		slice.Data = static_cast<char*>(storage.GetMappedData()) + slice.Offset;
+
+	return slice;
+}
+
+void vkc::BufferArena::Free(BufferSlice const& slice)
+{
+	assert(slice.Block < m_Blocks.size() && slice.Buffer == m_Blocks[slice.Block].Storage);
+	vmaVirtualFree(m_Blocks[slice.Block].VirtualBlock, slice.Allocation);
+}
+
+void vkc::BufferArena::Reset()
+{
+	for (Block const& block: m_Blocks)
+		vmaClearVirtualBlock(block.VirtualBlock);
+}
+
+void vkc::BufferArena::AddBlock(VkDeviceSize size)
+{
+	VmaVirtualBlockCreateInfo blockCreateInfo{};
+	blockCreateInfo.size  = size;
+	blockCreateInfo.flags = m_Algorithm;
+
+	VmaVirtualBlock virtualBlock{};
+	if (vmaCreateVirtualBlock(&blockCreateInfo, &virtualBlock) != VK_SUCCESS)
+		throw std::runtime_error("Failed to create virtual block");
+
+	m_Context.DeletionQueue.Push([virtualBlock]
+	{
+		// slices are not required to be freed before shutdown
+		vmaClearVirtualBlock(virtualBlock);
+		vmaDestroyVirtualBlock(virtualBlock);
+	});
+
+	m_Blocks.emplace_back(BufferBuilder{ m_Context }
+						  .SetRequiredMemoryFlags(m_RequiredFlags)
+						  .MapMemory(m_RequiredFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+						  .Build(m_Usage, size)
+						  , virtualBlock);
+}
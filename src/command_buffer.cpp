@@ -1,5 +1,7 @@
 #include "command_buffer.h"
 
+#include "command_pool.h"
+
 vkc::CommandBuffer::Status vkc::CommandBuffer::GetStatus(Context const& context)
 {
 	if (m_Status != Status::Submitted)
@@ -16,6 +18,14 @@ VkFence const& vkc::CommandBuffer::GetFence() const
 	return m_Fence;
 }
 
+bool vkc::CommandBuffer::HasCompleted(Context const& context, uint64_t submission)
+{
+	// buffer can only be submitted again once it's done with the previous submission
+	if (m_SubmissionCount > submission)
+		return true;
+	return m_SubmissionCount == submission && GetStatus(context) == Status::Ready;
+}
+
 void vkc::CommandBuffer::Begin(Context const& context, VkCommandBufferUsageFlags usage)
 {
 	assert(m_Status == Status::Ready);
@@ -24,6 +34,28 @@ void vkc::CommandBuffer::Begin(Context const& context, VkCommandBufferUsageFlags
 	beginInfo.flags = usage;
 	context.DispatchTable.beginCommandBuffer(*this, &beginInfo);
 	m_Status = Status::Recording;
+	m_Pooled = false;
+}
+
+void vkc::CommandBuffer::BeginSecondary
+(
+	Context const&                                   context
+	, VkCommandBufferInheritanceRenderingInfo const& renderingInfo
+	, VkCommandBufferUsageFlags                      usage
+)
+{
+	assert(m_Status == Status::Ready);
+	VkCommandBufferInheritanceInfo inheritanceInfo{};
+	inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritanceInfo.pNext = &renderingInfo;
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags            = usage | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	beginInfo.pInheritanceInfo = &inheritanceInfo;
+	context.DispatchTable.beginCommandBuffer(*this, &beginInfo);
+	m_Status = Status::Recording;
+	m_Pooled = false;
 }
 
 void vkc::CommandBuffer::End(Context const& context)
@@ -42,6 +74,7 @@ void vkc::CommandBuffer::Reuse()
 {
 	assert(m_Status != Status::Recording || m_Status != Status::Ready);
 	m_Status = Status::Executable;
+	m_Pooled = false;
 }
 
 void vkc::CommandBuffer::Submit
@@ -82,11 +115,15 @@ void vkc::CommandBuffer::Submit
 											 : m_Fence) != VK_SUCCESS)
 		throw std::runtime_error("failed to submit command buffer");
 
-	m_Status = Status::Submitted;
+	++m_SubmissionCount;
+	m_Status        = Status::Submitted;
+	m_TimelineValue = 0;
+	m_Owner->Track(*this);
 }
 
-vkc::CommandBuffer::CommandBuffer(Context& context, VkCommandPool commandPool, VkCommandBuffer buffer)
-	: m_Pool{ commandPool }
+vkc::CommandBuffer::CommandBuffer(Context& context, CommandPool& commandPool, VkCommandBuffer buffer)
+	: m_Owner{ &commandPool }
+	, m_Pool{ commandPool }
 	, m_CommandBuffer{ buffer }
 {
 	VkFenceCreateInfo fenceCreateInfo{};
@@ -1,6 +1,14 @@
 #include "command_pool.h"
 
-vkc::CommandPool::CommandPool(Context& context, uint32_t queueIndex, uint32_t bufferCount, VkCommandPoolCreateFlags flags)
+vkc::CommandPool::CommandPool
+(
+	Context&                   context
+	, uint32_t                 queueIndex
+	, uint32_t                 bufferCount
+	, VkCommandPoolCreateFlags flags
+	, VkCommandBufferLevel     level
+)
+	: m_Level{ level }
 {
 	VkCommandPoolCreateInfo poolInfo{};
 	poolInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -13,15 +21,16 @@ vkc::CommandPool::CommandPool(Context& context, uint32_t queueIndex, uint32_t bu
 	cmdBufferAllocateInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 	cmdBufferAllocateInfo.commandBufferCount = bufferCount;
 	cmdBufferAllocateInfo.commandPool        = m_Pool;
-	cmdBufferAllocateInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	cmdBufferAllocateInfo.level              = m_Level;
 
 	std::vector<VkCommandBuffer> commandBuffers(bufferCount);
 
 	if (context.DispatchTable.allocateCommandBuffers(&cmdBufferAllocateInfo, commandBuffers.data()) != VK_SUCCESS)
 		throw std::runtime_error("Failed to allocate command buffers");
 
+	m_Ready.reserve(bufferCount);
 	for (VkCommandBuffer const commandBuffer: commandBuffers)
-		m_CommandBuffers.emplace_back(CommandBuffer{ context, *this, commandBuffer });
+		m_Ready.push_back(Enlist(AddCommandBuffer(context, commandBuffer)));
 
 	context.DeletionQueue.Push([context = &context, pool = m_Pool, commandBuffers]
 	{
@@ -34,26 +43,33 @@ vkc::CommandPool::CommandPool(Context& context, uint32_t queueIndex, uint32_t bu
 
 vkc::CommandBuffer& vkc::CommandPool::AllocateCommandBuffer(Context& context)
 {
-	CommandBuffer* foundBuffer{};
+	if (m_Ready.empty())
+		Harvest(context);
 
-	// reset CPU status of all buffers and find any available
-	for (CommandBuffer& buffer: m_CommandBuffers)
-		if (buffer.GetStatus(context) == CommandBuffer::Status::Ready)
-			foundBuffer = &buffer;
+	while (!m_Ready.empty())
+	{
+		Entry const entry{ m_Ready.back() };
+		m_Ready.pop_back();
+
+		// taken back by Begin or Reuse of a caller that kept it
+		if (!IsCurrent(entry))
+			continue;
 
-	if (foundBuffer)
-		return *foundBuffer;
+		CommandBuffer& buffer = *entry.Buffer;
+		buffer.m_Pooled = false;
+		if (buffer.m_Status == CommandBuffer::Status::Ready)
+			return buffer;
+	}
 
 	VkCommandBufferAllocateInfo cmdBufferAllocateInfo{};
 	cmdBufferAllocateInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 	cmdBufferAllocateInfo.commandBufferCount = 1;
 	cmdBufferAllocateInfo.commandPool        = m_Pool;
-	cmdBufferAllocateInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	cmdBufferAllocateInfo.level              = m_Level;
 
 	VkCommandBuffer commandBuffer{};
 	if (context.DispatchTable.allocateCommandBuffers(&cmdBufferAllocateInfo, &commandBuffer) != VK_SUCCESS)
 		throw std::runtime_error("Failed to allocate command buffers");
-	m_CommandBuffers.emplace_back(CommandBuffer{ context, *this, commandBuffer });
 
 	context.DeletionQueue.Push([context = &context, pool = m_Pool, commandBuffer]
 	{
@@ -62,10 +78,95 @@ vkc::CommandBuffer& vkc::CommandPool::AllocateCommandBuffer(Context& context)
 												  , &commandBuffer);
 	});
 
-	return m_CommandBuffers.back();
+	return AddCommandBuffer(context, commandBuffer);
+}
+
+void vkc::CommandPool::Recycle(CommandBuffer& buffer)
+{
+	assert(!buffer.m_Pooled && buffer.m_Status == CommandBuffer::Status::Ready);
+
+	m_Ready.push_back(Enlist(buffer));
+}
+
+void vkc::CommandPool::TrackTimeline(CommandBuffer& buffer, uint64_t timelineValue)
+{
+	assert(buffer.m_Pooled && buffer.m_Status == CommandBuffer::Status::Submitted);
+
+	buffer.m_TimelineValue = timelineValue;
+}
+
+void vkc::CommandPool::Harvest(Context const& context)
+{
+	while (!m_Pending.empty())
+	{
+		if (IsCurrent(m_Pending.front()))
+		{
+			if (m_Pending.front().Buffer->GetStatus(context) != CommandBuffer::Status::Ready)
+				break;
+			m_Ready.push_back(m_Pending.front());
+		}
+		m_Pending.pop_front();
+	}
+}
+
+void vkc::CommandPool::Harvest(uint64_t completedValue)
+{
+	while (!m_Pending.empty())
+	{
+		if (IsCurrent(m_Pending.front()))
+		{
+			CommandBuffer& buffer = *m_Pending.front().Buffer;
+			if (buffer.m_TimelineValue == 0 || buffer.m_TimelineValue > completedValue)
+				break;
+
+			// the fence of the buffer is signaled as well, only its status is stale
+			buffer.m_Status = CommandBuffer::Status::Ready;
+			m_Ready.push_back(m_Pending.front());
+		}
+		m_Pending.pop_front();
+	}
+}
+
+void vkc::CommandPool::Reset(Context const& context)
+{
+	if (context.DispatchTable.resetCommandPool(m_Pool, 0) != VK_SUCCESS)
+		throw std::runtime_error("Failed to reset a command pool");
+
+	m_Pending.clear();
+	m_Ready.clear();
+	for (CommandBuffer& buffer: m_CommandBuffers)
+	{
+		buffer.m_Status        = CommandBuffer::Status::Ready;
+		buffer.m_TimelineValue = 0;
+		m_Ready.push_back(Enlist(buffer));
+	}
 }
 
 void vkc::CommandPool::Destroy(Context const& context) const
 {
 	context.DispatchTable.destroyCommandPool(m_Pool, nullptr);
 }
+
+void vkc::CommandPool::Track(CommandBuffer& buffer)
+{
+	// Begin and Reuse take the buffer out of the pool before it can be submitted again
+	assert(!buffer.m_Pooled);
+
+	m_Pending.push_back(Enlist(buffer));
+}
+
+vkc::CommandPool::Entry vkc::CommandPool::Enlist(CommandBuffer& buffer)
+{
+	buffer.m_Pooled = true;
+	return Entry{ &buffer, ++buffer.m_PoolTicket };
+}
+
+bool vkc::CommandPool::IsCurrent(Entry const& entry)
+{
+	return entry.Buffer->m_Pooled && entry.Buffer->m_PoolTicket == entry.Ticket;
+}
+
+vkc::CommandBuffer& vkc::CommandPool::AddCommandBuffer(Context& context, VkCommandBuffer commandBuffer)
+{
+	return m_CommandBuffers.emplace_back(CommandBuffer{ context, *this, commandBuffer });
+}
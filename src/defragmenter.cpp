@@ -0,0 +1,336 @@
+#include "defragmenter.h"
+
+#include <algorithm>
+
+vkc::Defragmenter::Defragmenter(Context& context)
+	: m_Context{ context } {}
+
+vkc::Defragmenter::~Defragmenter()
+{
+	if (!IsRunning())
+		return;
+
+	if (m_PassOwner)
+		m_Context.DispatchTable.deviceWaitIdle();
+	if (!m_PassOwner || EndPass())
+		End();
+}
+
+void vkc::Defragmenter::Track(Buffer& buffer, RelocationCallback callback)
+{
+	assert(buffer.m_Allocation != VK_NULL_HANDLE && buffer.m_OwnsAllocation);
+	m_Tracked.insert_or_assign(buffer.m_Allocation, Tracked{ &buffer, std::move(callback) });
+}
+
+void vkc::Defragmenter::Track(Image& image, RelocationCallback callback)
+{
+	assert(image.m_Allocation != VK_NULL_HANDLE && image.m_OwnsAllocation);
+	m_Tracked.insert_or_assign(image.m_Allocation, Tracked{ &image, std::move(callback) });
+}
+
+void vkc::Defragmenter::Untrack(VmaAllocation allocation)
+{
+	m_Tracked.erase(allocation);
+}
+
+void vkc::Defragmenter::Begin(Budget const& budget, VmaDefragmentationFlags algorithm, VmaPool pool)
+{
+	assert(!IsRunning());
+	m_Budget = budget;
+	m_Stats  = {};
+
+	VmaDefragmentationInfo defragmentationInfo{};
+	defragmentationInfo.flags                 = algorithm;
+	defragmentationInfo.pool                  = pool;
+	defragmentationInfo.maxBytesPerPass       = budget.BytesPerPass;
+	defragmentationInfo.maxAllocationsPerPass = budget.AllocationsPerPass;
+
+	if (vmaBeginDefragmentation(m_Context.Allocator, &defragmentationInfo, &m_Defragmentation) != VK_SUCCESS)
+		throw std::runtime_error("Failed to begin defragmentation");
+}
+
+bool vkc::Defragmenter::Step(CommandBuffer& commandBuffer)
+{
+	if (!IsRunning())
+		return false;
+
+	if (m_PassOwner)
+	{
+		if (!m_PassOwner->HasCompleted(m_Context, m_PassSubmission))
+			return true;
+		if (!EndPass())
+			return false;
+	}
+
+	VkResult const result{ vmaBeginDefragmentationPass(m_Context.Allocator, m_Defragmentation, &m_Pass) };
+	if (result == VK_SUCCESS)
+	{
+		End();
+		return false;
+	}
+	if (result != VK_INCOMPLETE)
+		throw std::runtime_error("Failed to begin defragmentation pass");
+
+	auto const start = std::chrono::steady_clock::now();
+
+	// moves of untracked, mapped or over budget allocations are ignored and stay where they are
+	PassCommands                     commands;
+	std::vector<RelocationCallback*> callbacks;
+	for (uint32_t i{ 0 }; i < m_Pass.moveCount; ++i)
+	{
+		VmaDefragmentationMove& move = m_Pass.pMoves[i];
+
+		auto const tracked = m_Tracked.find(move.srcAllocation);
+		bool relocated{ false };
+		if (tracked != m_Tracked.end() && std::chrono::steady_clock::now() - start < m_Budget.Time)
+			relocated = std::visit([&]<typename Resource>(Resource* resource)
+								   {
+									   if constexpr (std::is_same_v<Resource, Buffer>)
+										   return RelocateBuffer(commands, *resource, move.dstTmpAllocation);
+									   else
+										   return RelocateImage(commands, *resource, move.dstTmpAllocation);
+								   }
+								   , tracked->second.Resource);
+
+		if (!relocated)
+			move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+		else if (tracked->second.Callback)
+			callbacks.emplace_back(&tracked->second.Callback);
+	}
+
+	// nothing to wait for
+	if (commands.BufferCopies.empty() && commands.ImageCopies.empty())
+		return EndPass();
+
+	Record(commandBuffer, commands);
+	m_PassOwner      = &commandBuffer;
+	m_PassSubmission = commandBuffer.GetSubmissionCount() + 1;
+
+	for (RelocationCallback* callback: callbacks)
+		(*callback)();
+
+	return true;
+}
+
+bool vkc::Defragmenter::RelocateBuffer(PassCommands& commands, Buffer& buffer, VmaAllocation dstAllocation)
+{
+	if (buffer.m_Data || !(buffer.m_Usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT) || buffer.m_SharingMode != VK_SHARING_MODE_EXCLUSIVE)
+		return false;
+
+	VkBufferCreateInfo createInfo{};
+	createInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	createInfo.size        = buffer.m_Size;
+	createInfo.usage       = buffer.m_Usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	createInfo.sharingMode = buffer.m_SharingMode;
+
+	VkBuffer newBuffer{};
+	if (m_Context.DispatchTable.createBuffer(&createInfo, nullptr, &newBuffer) != VK_SUCCESS)
+		return false;
+	if (vmaBindBufferMemory(m_Context.Allocator, dstAllocation, newBuffer) != VK_SUCCESS)
+	{
+		m_Context.DispatchTable.destroyBuffer(newBuffer, nullptr);
+		return false;
+	}
+
+	commands.BufferCopies.emplace_back(buffer.m_Buffer, newBuffer, buffer.m_Size);
+	m_OldBuffers.emplace_back(buffer.m_Buffer);
+
+	buffer.m_Buffer = newBuffer;
+	buffer.m_Usage  = createInfo.usage;
+	return true;
+}
+
+bool vkc::Defragmenter::RelocateImage(PassCommands& commands, Image& image, VmaAllocation dstAllocation)
+{
+	if (!(image.m_Usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) || image.m_SharingMode != VK_SHARING_MODE_EXCLUSIVE)
+		return false;
+
+	VkImageCreateInfo createInfo{};
+	createInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	createInfo.flags         = image.m_CreateFlags;
+	createInfo.imageType     = image.m_Type;
+	createInfo.format        = image.m_Format;
+	createInfo.extent        = VkExtent3D{ image.m_Extent.width, image.m_Extent.height, 1 };
+	createInfo.mipLevels     = image.m_MipLevels;
+	createInfo.arrayLayers   = image.m_Layers;
+	createInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+	createInfo.tiling        = image.m_Tiling;
+	createInfo.usage         = image.m_Usage | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	createInfo.sharingMode   = image.m_SharingMode;
+	createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	VkImage newImage{};
+	if (m_Context.DispatchTable.createImage(&createInfo, nullptr, &newImage) != VK_SUCCESS)
+		return false;
+	if (vmaBindImageMemory(m_Context.Allocator, dstAllocation, newImage) != VK_SUCCESS)
+	{
+		m_Context.DispatchTable.destroyImage(newImage, nullptr);
+		return false;
+	}
+
+	VkImageMemoryBarrier2 barrier{};
+	barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+	barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+	barrier.subresourceRange.aspectMask     = image.m_AspectFlags;
+	barrier.subresourceRange.levelCount     = 1;
+	barrier.subresourceRange.layerCount     = 1;
+
+	// whole new image starts out as a copy destination
+	VkImageMemoryBarrier2& toDst = commands.PreBarriers.emplace_back(barrier);
+	toDst.dstStageMask                = VK_PIPELINE_STAGE_2_COPY_BIT;
+	toDst.dstAccessMask               = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	toDst.oldLayout                   = VK_IMAGE_LAYOUT_UNDEFINED;
+	toDst.newLayout                   = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	toDst.image                       = newImage;
+	toDst.subresourceRange.levelCount = image.m_MipLevels;
+	toDst.subresourceRange.layerCount = image.m_Layers;
+
+	PassCommands::ImageCopy& copy = commands.ImageCopies.emplace_back(image.m_Image, newImage);
+	for (uint32_t mipLevel{ 0 }; mipLevel < image.m_MipLevels; ++mipLevel)
+	{
+		VkImageCopy2& region = copy.Regions.emplace_back();
+		region.sType          = VK_STRUCTURE_TYPE_IMAGE_COPY_2;
+		region.srcSubresource = VkImageSubresourceLayers{ image.m_AspectFlags, mipLevel, 0, image.m_Layers };
+		region.dstSubresource = region.srcSubresource;
+		region.extent         = VkExtent3D{
+			std::max(image.m_Extent.width >> mipLevel, 1u)
+			, std::max(image.m_Extent.height >> mipLevel, 1u)
+			, 1
+		};
+	}
+
+	// old layouts are restored on the new image, undefined contents stay a copy destination,
+	// a uniformly laid out image needs a single barrier on each side
+	uint32_t const rangeLayers{ image.HasUniformLayout() ? image.m_Layers : 1 };
+	uint32_t const rangeLevels{ image.HasUniformLayout() ? image.m_MipLevels : 1 };
+	barrier.subresourceRange.layerCount = rangeLayers;
+	barrier.subresourceRange.levelCount = rangeLevels;
+
+	for (uint32_t layer{ 0 }; layer < image.m_Layers; layer += rangeLayers)
+		for (uint32_t mipLevel{ 0 }; mipLevel < image.m_MipLevels; mipLevel += rangeLevels)
+		{
+			VkImageLayout layout{ image.GetLayout(layer, mipLevel) };
+
+			barrier.subresourceRange.baseArrayLayer = layer;
+			barrier.subresourceRange.baseMipLevel   = mipLevel;
+
+			VkImageMemoryBarrier2& toSrc = commands.PreBarriers.emplace_back(barrier);
+			toSrc.srcStageMask  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+			toSrc.srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
+			toSrc.dstStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+			toSrc.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+			toSrc.oldLayout     = layout;
+			toSrc.newLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			toSrc.image         = image.m_Image;
+
+			if (layout == VK_IMAGE_LAYOUT_UNDEFINED)
+			{
+				layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				image.SetLayout(layer, rangeLayers, mipLevel, rangeLevels, layout);
+			}
+
+			VkImageMemoryBarrier2& restore = commands.PostBarriers.emplace_back(barrier);
+			restore.srcStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+			restore.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+			restore.dstStageMask  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+			restore.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+			restore.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			restore.newLayout     = layout;
+			restore.image         = newImage;
+		}
+
+	m_OldImages.emplace_back(image.m_Image);
+	image.m_Views->Release(m_OldViews);
+
+	image.m_Image = newImage;
+	image.m_Usage = createInfo.usage;
+	return true;
+}
+
+void vkc::Defragmenter::Record(CommandBuffer const& commandBuffer, PassCommands const& commands) const
+{
+	bool const hasBufferCopies{ !commands.BufferCopies.empty() };
+
+	VkMemoryBarrier2 memoryBarrier{};
+	memoryBarrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+	memoryBarrier.srcStageMask  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+	memoryBarrier.srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
+	memoryBarrier.dstStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+
+	VkDependencyInfo dependencyInfo{};
+	dependencyInfo.sType                   = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dependencyInfo.memoryBarrierCount      = hasBufferCopies ? 1 : 0;
+	dependencyInfo.pMemoryBarriers         = &memoryBarrier;
+	dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(commands.PreBarriers.size());
+	dependencyInfo.pImageMemoryBarriers    = commands.PreBarriers.data();
+	m_Context.DispatchTable.cmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+
+	for (PassCommands::BufferCopy const& bufferCopy: commands.BufferCopies)
+	{
+		VkBufferCopy2 copyRegion{};
+		copyRegion.sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
+		copyRegion.size  = bufferCopy.Size;
+
+		VkCopyBufferInfo2 info{};
+		info.sType       = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+		info.srcBuffer   = bufferCopy.Src;
+		info.dstBuffer   = bufferCopy.Dst;
+		info.regionCount = 1;
+		info.pRegions    = &copyRegion;
+		m_Context.DispatchTable.cmdCopyBuffer2(commandBuffer, &info);
+	}
+
+	for (PassCommands::ImageCopy const& imageCopy: commands.ImageCopies)
+	{
+		VkCopyImageInfo2 info{};
+		info.sType          = VK_STRUCTURE_TYPE_COPY_IMAGE_INFO_2;
+		info.srcImage       = imageCopy.Src;
+		info.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		info.dstImage       = imageCopy.Dst;
+		info.dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		info.regionCount    = static_cast<uint32_t>(imageCopy.Regions.size());
+		info.pRegions       = imageCopy.Regions.data();
+		m_Context.DispatchTable.cmdCopyImage2(commandBuffer, &info);
+	}
+
+	memoryBarrier.srcStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+	memoryBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	memoryBarrier.dstStageMask  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+	dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(commands.PostBarriers.size());
+	dependencyInfo.pImageMemoryBarriers    = commands.PostBarriers.data();
+	m_Context.DispatchTable.cmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+}
+
+bool vkc::Defragmenter::EndPass()
+{
+	// handles bound to the old memory have to be gone before VMA frees it
+	for (VkBuffer const buffer: m_OldBuffers)
+		m_Context.DispatchTable.destroyBuffer(buffer, nullptr);
+	for (VkImageView const view: m_OldViews)
+		m_Context.DispatchTable.destroyImageView(view, nullptr);
+	for (VkImage const image: m_OldImages)
+		m_Context.DispatchTable.destroyImage(image, nullptr);
+	m_OldBuffers.clear();
+	m_OldImages.clear();
+	m_OldViews.clear();
+	m_PassOwner = nullptr;
+
+	VkResult const result{ vmaEndDefragmentationPass(m_Context.Allocator, m_Defragmentation, &m_Pass) };
+
+	if (result == VK_SUCCESS)
+	{
+		End();
+		return false;
+	}
+	return true;
+}
+
+void vkc::Defragmenter::End()
+{
+	vmaEndDefragmentation(m_Context.Allocator, m_Defragmentation, &m_Stats);
+	m_Defragmentation = VK_NULL_HANDLE;
+}
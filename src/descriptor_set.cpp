@@ -34,6 +34,13 @@ vkc::DescriptorSet& vkc::DescriptorSet::AddWriteDescriptor
 	return *this;
 }
 
+vkc::DescriptorSet& vkc::DescriptorSet::AddWriteDescriptor
+(std::span<BufferSlice const> slices, VkDescriptorType type, uint32_t binding, uint32_t arrayElement)
+{
+	std::vector<VkDescriptorBufferInfo>& bufferInfos = m_SliceBufferInfos.emplace_back(slices.begin(), slices.end());
+	return AddWriteDescriptor(bufferInfos, type, binding, arrayElement);
+}
+
 void vkc::DescriptorSet::Update(Context const& context)
 {
 	context.DispatchTable.updateDescriptorSets(static_cast<uint32_t>(m_WriteDescriptorSets.size())
@@ -41,6 +48,7 @@ void vkc::DescriptorSet::Update(Context const& context)
 											   , 0
 											   , nullptr);
 	m_WriteDescriptorSets.clear();
+	m_SliceBufferInfos.clear();
 }
 
 vkc::DescriptorSetBuilder::DescriptorSetBuilder(Context& context)
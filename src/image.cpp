@@ -1,5 +1,7 @@
 #include "image.h"
 
+#include "texture_stream.h"
+
 vkc::ImageView vkc::Image::CreateView
 (
 	Context&          context
@@ -12,23 +14,13 @@ vkc::ImageView vkc::Image::CreateView
 	addToQueue
 ) const
 {
-	ImageView imageView{};
-
-	VkImageViewCreateInfo imageViewCreateInfo{};
-	imageViewCreateInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-	imageViewCreateInfo.flags                           = 0;
-	imageViewCreateInfo.image                           = *this;
-	imageViewCreateInfo.viewType                        = imageView.m_Type = type;
-	imageViewCreateInfo.format                          = m_Format;
-	imageViewCreateInfo.subresourceRange.aspectMask     = m_AspectFlags;
-	imageViewCreateInfo.subresourceRange.layerCount     = imageView.m_LayerCount    = layerCount;
-	imageViewCreateInfo.subresourceRange.levelCount     = imageView.m_MipLevelCount = levelCount;
-	imageViewCreateInfo.subresourceRange.baseMipLevel   = imageView.m_BaseMipLevel  = baseMipLevel;
-	imageViewCreateInfo.subresourceRange.baseArrayLayer = imageView.m_BaseLayer     = baseLayer;
-
-	if (auto const result = context.DispatchTable.createImageView(&imageViewCreateInfo, nullptr, imageView);
-		result != VK_SUCCESS)
-		throw std::runtime_error("Failed to create image view");
+	ImageViewDescription description{};
+	description.Type         = type;
+	description.BaseLayer    = baseLayer;
+	description.LayerCount   = layerCount;
+	description.BaseMipLevel = baseMipLevel;
+	description.LevelCount   = levelCount;
+	ImageView imageView{ MakeView(context, description) };
 
 	if (addToQueue)
 		context.DeletionQueue.Push([context = &context, imageView = imageView.m_ImageView]
@@ -39,31 +31,76 @@ vkc::ImageView vkc::Image::CreateView
 	return imageView;
 }
 
+vkc::ImageView const& vkc::Image::GetView(Context const& context, ImageViewDescription const& description) const
+{
+	if (ImageView const* view{ m_Views->Find(description) })
+		return *view;
+	return m_Views->Insert(description, MakeView(context, description));
+}
+
+void vkc::Image::DestroyViews(Context const& context) const
+{
+	m_Views->Destroy(context);
+}
+
 void vkc::Image::Destroy(Context const& context) const
 {
+	m_Views->Destroy(context);
+
+	if (!m_OwnsAllocation)
+	{
+		context.DispatchTable.destroyImage(m_Image, nullptr);
+		return;
+	}
+
+	if (m_MemoryStats)
+		m_MemoryStats->Untrack(m_Allocation);
 	vmaDestroyImage(context.Allocator, *this, m_Allocation);
 }
 
-void vkc::Image::MakeTransition(Context const& context, VkCommandBuffer commandBuffer, Transition const& transition)
+void vkc::Image::BindMemory(Context const& context, VmaAllocation allocation, VkDeviceSize offset)
 {
-	bool hasEqualLayouts{ true };
+	assert(!m_OwnsAllocation);
 
-	VkImageLayout const baseLayout = GetLayout(transition.BaseLayer, transition.BaseMipLevel);
+	if (vmaBindImageMemory2(context.Allocator, allocation, offset, m_Image, nullptr) != VK_SUCCESS)
+		throw std::runtime_error("Failed to bind image memory");
+	m_Allocation = allocation;
+}
 
-	for (uint32_t layer{ transition.BaseLayer }; layer < transition.BaseLayer + transition.LayerCount && hasEqualLayouts; ++layer)
-		for (uint32_t mipLevel{ transition.BaseMipLevel }; mipLevel < transition.BaseMipLevel + transition.LevelCount; ++mipLevel)
-			if (baseLayout != GetLayout(layer, mipLevel))
-			{
-				hasEqualLayouts = false;
-				break;
-			}
+void vkc::Image::Discard(ResourceState const& previousOccupant)
+{
+	m_Layouts.assign(1, VK_IMAGE_LAYOUT_UNDEFINED);
+	m_State = previousOccupant;
+}
 
-	std::vector const barriers
-	{
-		hasEqualLayouts
-		? MakeBarriersForEqualLayouts(transition)
-		: MakeBarriersForDifferentLayouts(transition)
-	};
+vkc::ImageView vkc::Image::MakeView(Context const& context, ImageViewDescription const& description) const
+{
+	ImageView imageView{};
+
+	VkImageViewCreateInfo imageViewCreateInfo{};
+	imageViewCreateInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	imageViewCreateInfo.flags                           = 0;
+	imageViewCreateInfo.image                           = *this;
+	imageViewCreateInfo.viewType                        = imageView.m_Type = description.Type;
+	imageViewCreateInfo.format                          = description.Format == VK_FORMAT_UNDEFINED ? m_Format : description.Format;
+	imageViewCreateInfo.components                      = description.Swizzle;
+	imageViewCreateInfo.subresourceRange.aspectMask     = m_AspectFlags;
+	imageViewCreateInfo.subresourceRange.layerCount     = imageView.m_LayerCount    = description.LayerCount;
+	imageViewCreateInfo.subresourceRange.levelCount     = imageView.m_MipLevelCount = description.LevelCount;
+	imageViewCreateInfo.subresourceRange.baseMipLevel   = imageView.m_BaseMipLevel  = description.BaseMipLevel;
+	imageViewCreateInfo.subresourceRange.baseArrayLayer = imageView.m_BaseLayer     = description.BaseLayer;
+
+	if (auto const result = context.DispatchTable.createImageView(&imageViewCreateInfo, nullptr, imageView);
+		result != VK_SUCCESS)
+		throw std::runtime_error("Failed to create image view");
+	return imageView;
+}
+
+void vkc::Image::MakeTransition(Context const& context, VkCommandBuffer commandBuffer, Transition const& transition)
+{
+	std::vector<VkImageMemoryBarrier2> barriers{};
+	AppendTransition(barriers, transition);
+	SynchronizeState(transition);
 
 	VkDependencyInfo dependencyInfo{};
 	dependencyInfo.sType                   = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
@@ -71,10 +108,180 @@ void vkc::Image::MakeTransition(Context const& context, VkCommandBuffer commandB
 	dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
 	dependencyInfo.pImageMemoryBarriers    = barriers.data();
 	context.DispatchTable.cmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+}
+
+void vkc::Image::GenerateMips
+(
+	Context const&          context
+	, VkCommandBuffer       commandBuffer
+	, VkImageLayout         finalLayout
+	, VkPipelineStageFlags2 dstStageMask
+	, VkAccessFlags2        dstAccessMask
+)
+{
+	assert((m_Usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) && (m_Usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT));
+
+	VkFormatProperties formatProperties{};
+	context.InstanceDispatchTable.getPhysicalDeviceFormatProperties(context.Device.physical_device, m_Format, &formatProperties);
+	VkFormatFeatureFlags const features{
+		m_Tiling == VK_IMAGE_TILING_OPTIMAL
+		? formatProperties.optimalTilingFeatures
+		: formatProperties.linearTilingFeatures
+	};
+	if (!(features & VK_FORMAT_FEATURE_BLIT_SRC_BIT) || !(features & VK_FORMAT_FEATURE_BLIT_DST_BIT))
+		throw std::runtime_error("Image format does not support blits required for mip generation");
+
+	// formats without linear filtering still get a usable, if blockier, chain
+	VkFilter const filter{ features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT ? VK_FILTER_LINEAR : VK_FILTER_NEAREST };
+
+	Transition toFinal{};
+	toFinal.SrcStageMask  = VK_PIPELINE_STAGE_2_BLIT_BIT;
+	toFinal.SrcAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+	toFinal.DstStageMask  = dstStageMask;
+	toFinal.DstAccessMask = dstAccessMask;
+	toFinal.NewLayout     = finalLayout;
+	toFinal.LayerCount    = m_Layers;
+
+	if (m_MipLevels == 1)
+	{
+		toFinal.SrcStageMask  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+		toFinal.SrcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
+		MakeTransition(context, commandBuffer, toFinal);
+		return;
+	}
+
+	std::vector<VkImageMemoryBarrier2> barriers{};
+
+	VkDependencyInfo dependencyInfo{};
+	dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+
+	auto const flushBarriers = [&]
+	{
+		dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+		dependencyInfo.pImageMemoryBarriers    = barriers.data();
+		context.DispatchTable.cmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+		barriers.clear();
+	};
+
+	// base level becomes the first source, the rest of the chain a destination whose contents are discarded
+	Transition toSource{};
+	toSource.SrcStageMask  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+	toSource.SrcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
+	toSource.DstStageMask  = VK_PIPELINE_STAGE_2_BLIT_BIT;
+	toSource.DstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+	toSource.NewLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	toSource.LayerCount    = m_Layers;
+	AppendTransition(barriers, toSource);
+
+	SetLayout(0, m_Layers, 1, m_MipLevels - 1, VK_IMAGE_LAYOUT_UNDEFINED);
+
+	Transition toDestination{};
+	toDestination.DstStageMask  = VK_PIPELINE_STAGE_2_BLIT_BIT;
+	toDestination.DstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	toDestination.NewLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	toDestination.LayerCount    = m_Layers;
+	toDestination.BaseMipLevel  = 1;
+	toDestination.LevelCount    = m_MipLevels - 1;
+	AppendTransition(barriers, toDestination);
+	flushBarriers();
+
+	for (uint32_t mipLevel{ 1 }; mipLevel < m_MipLevels; ++mipLevel)
+	{
+		VkExtent2D const srcExtent{ GetMipExtent(mipLevel - 1) };
+		VkExtent2D const dstExtent{ GetMipExtent(mipLevel) };
+
+		VkImageBlit2 blit{};
+		blit.sType          = VK_STRUCTURE_TYPE_IMAGE_BLIT_2;
+		blit.srcSubresource = VkImageSubresourceLayers{ m_AspectFlags, mipLevel - 1, 0, m_Layers };
+		blit.srcOffsets[1]  = VkOffset3D{ static_cast<int32_t>(srcExtent.width), static_cast<int32_t>(srcExtent.height), 1 };
+		blit.dstSubresource = VkImageSubresourceLayers{ m_AspectFlags, mipLevel, 0, m_Layers };
+		blit.dstOffsets[1]  = VkOffset3D{ static_cast<int32_t>(dstExtent.width), static_cast<int32_t>(dstExtent.height), 1 };
+
+		VkBlitImageInfo2 blitInfo{};
+		blitInfo.sType          = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2;
+		blitInfo.srcImage       = m_Image;
+		blitInfo.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		blitInfo.dstImage       = m_Image;
+		blitInfo.dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		blitInfo.regionCount    = 1;
+		blitInfo.pRegions       = &blit;
+		blitInfo.filter         = filter;
+		context.DispatchTable.cmdBlitImage2(commandBuffer, &blitInfo);
+
+		// finished source goes to its final layout together with the written level becoming the next source
+		toFinal.BaseMipLevel = mipLevel - 1;
+		AppendTransition(barriers, toFinal);
+
+		// last level is never read by a blit and goes straight to its final layout
+		Transition written{ mipLevel == m_MipLevels - 1 ? toFinal : toSource };
+		written.SrcStageMask  = VK_PIPELINE_STAGE_2_BLIT_BIT;
+		written.SrcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		written.BaseMipLevel  = mipLevel;
+		AppendTransition(barriers, written);
+		flushBarriers();
+	}
+
+	m_State.Synchronize(Access{ dstStageMask, dstAccessMask, finalLayout });
+}
+
+void vkc::Image::AppendTransition(std::vector<VkImageMemoryBarrier2>& barriers, Transition const& transition)
+{
+	bool const equalLayouts{ HasEqualLayouts(transition) };
+	std::vector const newBarriers
+	{
+		equalLayouts
+		? MakeBarriersForEqualLayouts(transition)
+		: MakeGreedyBarriersForDifferentLayouts(transition)
+	};
+	barriers.insert(barriers.end(), newBarriers.begin(), newBarriers.end());
+
+	m_EmittedBarriers += newBarriers.size();
+	m_PerSubresourceBarriers += equalLayouts ? newBarriers.size() : uint64_t{ transition.LayerCount } * transition.LevelCount;
+
+	SetLayout(transition.BaseLayer, transition.LayerCount, transition.BaseMipLevel, transition.LevelCount, transition.NewLayout);
+}
+
+void vkc::Image::SynchronizeState(Transition const& transition)
+{
+	// partial transitions keep the older, more conservative state
+	if (transition.LayerCount == m_Layers && transition.LevelCount == m_MipLevels)
+		m_State.Synchronize(Access{ transition.DstStageMask, transition.DstAccessMask, transition.NewLayout });
+}
 
-	for (uint32_t layer{}; layer < transition.LayerCount; ++layer)
-		for (uint32_t mipLevel{}; mipLevel < transition.LevelCount; ++mipLevel)
-			m_Layouts[transition.BaseLayer + layer][transition.BaseMipLevel + mipLevel] = transition.NewLayout;
+bool vkc::Image::HasEqualLayouts(Transition const& transition) const
+{
+	if (HasUniformLayout())
+		return true;
+
+	VkImageLayout const baseLayout{ GetLayout(transition.BaseLayer, transition.BaseMipLevel) };
+	for (uint32_t layer{ transition.BaseLayer }; layer < transition.BaseLayer + transition.LayerCount; ++layer)
+	{
+		auto const levels = m_Layouts.begin() + layer * m_MipLevels + transition.BaseMipLevel;
+		if (!std::all_of(levels, levels + transition.LevelCount, [baseLayout](VkImageLayout layout) { return layout == baseLayout; }))
+			return false;
+	}
+	return true;
+}
+
+void vkc::Image::SetLayout(uint32_t baseLayer, uint32_t layerCount, uint32_t baseMipLevel, uint32_t levelCount, VkImageLayout layout)
+{
+	assert(baseLayer + layerCount <= m_Layers && baseMipLevel + levelCount <= m_MipLevels);
+
+	if (layerCount == m_Layers && levelCount == m_MipLevels)
+	{
+		m_Layouts.assign(1, layout);
+		return;
+	}
+
+	if (HasUniformLayout())
+	{
+		if (m_Layouts[0] == layout)
+			return;
+		m_Layouts.assign(static_cast<size_t>(m_Layers) * m_MipLevels, m_Layouts[0]);
+	}
+
+	for (uint32_t layer{ baseLayer }; layer < baseLayer + layerCount; ++layer)
+		std::fill_n(m_Layouts.begin() + layer * m_MipLevels + baseMipLevel, levelCount, layout);
 }
 
 void vkc::Image::ConvertFromSwapchainVkImages(Context& context, std::vector<Image>& convertedImages)
@@ -93,8 +300,7 @@ void vkc::Image::ConvertFromSwapchainVkImages(Context& context, std::vector<Imag
 		convertedImage.m_AspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
 		convertedImage.m_MipLevels   = 1;
 		convertedImage.m_Layers      = 1;
-		convertedImage.m_Layouts.resize(1);
-		convertedImage.m_Layouts[0].resize(1);
+		convertedImage.m_Layouts.assign(1, VK_IMAGE_LAYOUT_UNDEFINED);
 		convertedImages.emplace_back(std::move(convertedImage));
 	}
 }
@@ -123,36 +329,102 @@ std::vector<VkImageMemoryBarrier2> vkc::Image::MakeBarriersForEqualLayouts(Trans
 	return { memoryBarrier };
 }
 
-std::vector<VkImageMemoryBarrier2> vkc::Image::MakeBarriersForDifferentLayouts(Transition const& transition) const
+std::vector<VkImageMemoryBarrier2> vkc::Image::MakeGreedyBarriersForDifferentLayouts(Transition const& transition) const
 {
-	// could make it find sequential equal layouts to reduce the number of barriers used for performance
+	uint32_t const layerCount{ transition.LayerCount };
+	uint32_t const levelCount{ transition.LevelCount };
 
-	std::vector<VkImageMemoryBarrier2> barriers{};
-	for (uint32_t layer{ transition.BaseLayer }; layer < transition.LayerCount; ++layer)
-		for (uint32_t mipLevel{ transition.BaseMipLevel }; mipLevel < transition.LevelCount; ++mipLevel)
-			barriers.emplace_back(VkImageMemoryBarrier2{
-									  .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2
-									  , .pNext = nullptr
-									  , .srcStageMask = transition.SrcStageMask
-									  , .srcAccessMask = transition.SrcAccessMask
-									  , .dstStageMask = transition.DstStageMask
-									  , .dstAccessMask = transition.DstAccessMask
-									  , .oldLayout = GetLayout(layer, mipLevel)
-									  , .newLayout = transition.NewLayout
-									  , .srcQueueFamilyIndex = transition.SrcQueue
-									  , .dstQueueFamilyIndex = transition.DstQueue
-									  , .image = m_Image
-									  , .subresourceRange
-									  {
-										  m_AspectFlags
-										  , mipLevel
-										  , 1
-										  , layer
-										  , 1
-									  }
-								  });
-
-	return barriers;
+	auto const layoutAt = [&](uint32_t layer, uint32_t mipLevel)
+	{
+		return GetLayout(transition.BaseLayer + layer, transition.BaseMipLevel + mipLevel);
+	};
+
+	// greedy maximal rectangles of equal old layouts, grown along one axis first and then along the other
+	auto const coalesceGreedy = [&](bool mipsFirst)
+	{
+		std::vector<bool> covered(static_cast<size_t>(layerCount) * levelCount);
+		auto const isFree = [&](uint32_t layer, uint32_t mipLevel, VkImageLayout layout)
+		{
+			return !covered[layer * levelCount + mipLevel] && layoutAt(layer, mipLevel) == layout;
+		};
+
+		std::vector<VkImageMemoryBarrier2> barriers{};
+		for (uint32_t layer{ 0 }; layer < layerCount; ++layer)
+			for (uint32_t mipLevel{ 0 }; mipLevel < levelCount; ++mipLevel)
+			{
+				if (covered[layer * levelCount + mipLevel])
+					continue;
+
+				VkImageLayout const layout{ layoutAt(layer, mipLevel) };
+				uint32_t            layers{ 1 };
+				uint32_t            levels{ 1 };
+
+				auto const rowIsFree = [&](uint32_t row)
+				{
+					for (uint32_t level{ mipLevel }; level < mipLevel + levels; ++level)
+						if (!isFree(row, level, layout))
+							return false;
+					return true;
+				};
+				auto const columnIsFree = [&](uint32_t column)
+				{
+					for (uint32_t row{ layer }; row < layer + layers; ++row)
+						if (!isFree(row, column, layout))
+							return false;
+					return true;
+				};
+
+				if (mipsFirst)
+				{
+					while (mipLevel + levels < levelCount && isFree(layer, mipLevel + levels, layout))
+						++levels;
+					while (layer + layers < layerCount && rowIsFree(layer + layers))
+						++layers;
+				}
+				else
+				{
+					while (layer + layers < layerCount && isFree(layer + layers, mipLevel, layout))
+						++layers;
+					while (mipLevel + levels < levelCount && columnIsFree(mipLevel + levels))
+						++levels;
+				}
+
+				for (uint32_t row{ layer }; row < layer + layers; ++row)
+					for (uint32_t level{ mipLevel }; level < mipLevel + levels; ++level)
+						covered[row * levelCount + level] = true;
+
+				barriers.emplace_back(VkImageMemoryBarrier2{
+										  .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2
+										  , .pNext = nullptr
+										  , .srcStageMask = transition.SrcStageMask
+										  , .srcAccessMask = transition.SrcAccessMask
+										  , .dstStageMask = transition.DstStageMask
+										  , .dstAccessMask = transition.DstAccessMask
+										  , .oldLayout = layout
+										  , .newLayout = transition.NewLayout
+										  , .srcQueueFamilyIndex = transition.SrcQueue
+										  , .dstQueueFamilyIndex = transition.DstQueue
+										  , .image = m_Image
+										  , .subresourceRange
+										  {
+											  m_AspectFlags
+											  , transition.BaseMipLevel + mipLevel
+											  , levels
+											  , transition.BaseLayer + layer
+											  , layers
+										  }
+									  });
+			}
+		return barriers;
+	};
+
+	// layer runs (e.g. atlas slices) and mip runs (e.g. partially streamed chains) favour different orientations
+	std::vector<VkImageMemoryBarrier2> mipsFirst{ coalesceGreedy(true) };
+	if (mipsFirst.size() <= 2)
+		return mipsFirst;
+
+	std::vector<VkImageMemoryBarrier2> layersFirst{ coalesceGreedy(false) };
+	return layersFirst.size() < mipsFirst.size() ? layersFirst : mipsFirst;
 }
 
 vkc::ImageBuilder& vkc::ImageBuilder::SetFormat(VkFormat format)
@@ -221,7 +493,101 @@ vkc::ImageBuilder& vkc::ImageBuilder::SetMemoryFlags(VmaAllocationCreateFlags cr
 	return *this;
 }
 
+vkc::ImageBuilder& vkc::ImageBuilder::SetPool(VmaPool pool)
+{
+	m_Pool = pool;
+	return *this;
+}
+
+vkc::ImageBuilder& vkc::ImageBuilder::SetName(std::string name)
+{
+	m_Name = std::move(name);
+	return *this;
+}
+
+vkc::ImageBuilder& vkc::ImageBuilder::SetCategory(std::string category)
+{
+	m_Category = std::move(category);
+	return *this;
+}
+
+vkc::ImageBuilder& vkc::ImageBuilder::SetFileName(std::filesystem::path const& fileName)
+{
+	m_FileName = fileName.string();
+	return *this;
+}
+
 vkc::Image vkc::ImageBuilder::Build(VkImageUsageFlags usage, bool addToQueue) const
+{
+	VkImageCreateInfo const createInfo{ MakeCreateInfo(usage) };
+
+	VmaAllocationCreateInfo vmaAllocationCreateInfo{};
+	vmaAllocationCreateInfo.flags = m_MemoryFlags;
+	vmaAllocationCreateInfo.usage = m_MemoryUsage;
+	vmaAllocationCreateInfo.pool  = m_Pool;
+
+	Image image{ MakeImage(usage) };
+	vmaCreateImage(m_Context.Allocator, &createInfo, &vmaAllocationCreateInfo, image, &image.m_Allocation, nullptr);
+	if (!m_Name.empty())
+		vmaSetAllocationName(m_Context.Allocator, image.m_Allocation, m_Name.c_str());
+	m_Context.MemoryStats.Track(m_Context.Allocator, image.m_Allocation, m_Category);
+	image.m_MemoryStats = &m_Context.MemoryStats;
+
+	if (addToQueue)
+		m_Context.DeletionQueue.Push([context = &m_Context, image = image.m_Image, allocation = image.m_Allocation, views = image.m_Views]
+		{
+			views->Destroy(*context);
+			context->MemoryStats.Untrack(allocation);
+			vmaDestroyImage(context->Allocator, image, allocation);
+		});
+	return image;
+}
+
+vkc::Image vkc::ImageBuilder::BuildAliased(VkImageUsageFlags usage, bool addToQueue) const
+{
+	VkImageCreateInfo const createInfo{ MakeCreateInfo(usage) };
+
+	Image image{ MakeImage(usage) };
+	image.m_OwnsAllocation = false;
+	if (m_Context.DispatchTable.createImage(&createInfo, nullptr, image) != VK_SUCCESS)
+		throw std::runtime_error("Failed to create aliased image");
+
+	if (addToQueue)
+		m_Context.DeletionQueue.Push([context = &m_Context, image = image.m_Image, views = image.m_Views]
+		{
+			views->Destroy(*context);
+			context->DispatchTable.destroyImage(image, nullptr);
+		});
+	return image;
+}
+
+vkc::TextureStream vkc::ImageBuilder::BuildStreamed(VkImageUsageFlags usage, bool addToQueue) const
+{
+	assert(!m_FileName.empty());
+	TextureFile file{ m_FileName };
+
+	// memory and naming settings carry over, everything describing the contents comes from the file
+	ImageBuilder builder{ m_Context };
+	builder.m_Format        = file.GetFormat();
+	builder.m_Extent        = file.GetExtent();
+	builder.m_Tiling        = VK_IMAGE_TILING_OPTIMAL;
+	builder.m_ImageType     = VK_IMAGE_TYPE_2D;
+	builder.m_CreationFlags = m_CreationFlags | (file.IsCubemap() ? VkImageCreateFlags{ VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT } : 0);
+	builder.m_AspectFlags   = VK_IMAGE_ASPECT_COLOR_BIT;
+	builder.m_MemoryFlags   = m_MemoryFlags;
+	builder.m_SharingMode   = m_SharingMode;
+	builder.m_MemoryUsage   = m_MemoryUsage;
+	builder.m_Pool          = m_Pool;
+	builder.m_Layers        = file.GetLayerCount();
+	builder.m_MipLevels     = file.GetMipLevelCount();
+	builder.m_Name          = m_Name.empty() ? m_FileName : m_Name;
+	builder.m_Category      = m_Category;
+
+	Image image{ builder.Build(usage | VK_IMAGE_USAGE_TRANSFER_DST_BIT, addToQueue) };
+	return TextureStream{ std::move(file), std::move(image) };
+}
+
+VkImageCreateInfo vkc::ImageBuilder::MakeCreateInfo(VkImageUsageFlags usage) const
 {
 	VkImageCreateInfo createInfo{};
 	createInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -235,31 +601,26 @@ vkc::Image vkc::ImageBuilder::Build(VkImageUsageFlags usage, bool addToQueue) co
 	createInfo.extent.depth  = 1;
 	createInfo.arrayLayers   = m_Layers;
 	createInfo.usage         = usage;
-	createInfo.mipLevels     = 1;
+	createInfo.mipLevels     = m_MipLevels;
 	createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 	createInfo.sharingMode   = m_SharingMode;
 	createInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+	return createInfo;
+}
 
-	VmaAllocationCreateInfo vmaAllocationCreateInfo{};
-	vmaAllocationCreateInfo.flags = m_MemoryFlags;
-	vmaAllocationCreateInfo.usage = m_MemoryUsage;
-
+vkc::Image vkc::ImageBuilder::MakeImage(VkImageUsageFlags usage) const
+{
 	Image image{};
 	image.m_AspectFlags = m_AspectFlags;
 	image.m_Extent      = m_Extent;
 	image.m_Format      = m_Format;
 	image.m_Layers      = m_Layers;
 	image.m_MipLevels   = m_MipLevels;
-	image.m_Layouts.resize(m_Layers);
-	for (auto& layers: image.m_Layouts)
-		layers.resize(m_MipLevels, VK_IMAGE_LAYOUT_UNDEFINED);
-
-	vmaCreateImage(m_Context.Allocator, &createInfo, &vmaAllocationCreateInfo, image, &image.m_Allocation, nullptr);
-
-	if (addToQueue)
-		m_Context.DeletionQueue.Push([context = &m_Context, image = image.m_Image, allocation = image.m_Allocation]
-		{
-			vmaDestroyImage(context->Allocator, image, allocation);
-		});
+	image.m_Usage       = usage;
+	image.m_Tiling      = m_Tiling;
+	image.m_Type        = m_ImageType;
+	image.m_CreateFlags = m_CreationFlags;
+	image.m_SharingMode = m_SharingMode;
+	image.m_Layouts.assign(1, VK_IMAGE_LAYOUT_UNDEFINED);
 	return image;
 }
@@ -0,0 +1,191 @@
+#include "image_readback.h"
+
+#include "texture_file.h"
+
+vkc::ImageReadback::ImageReadback(Context& context, VkDeviceSize slotSize, uint32_t slotCount)
+{
+	assert(slotCount > 0);
+
+	// cached memory keeps reads through the mapping from crawling over uncached write-combined pages
+	m_Slots.reserve(slotCount);
+	for (uint32_t i{ 0 }; i < slotCount; ++i)
+		m_Slots.emplace_back(
+			BufferBuilder{ context }
+			.SetRequiredMemoryFlags(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+			.SetPreferredMemoryFlags(VK_MEMORY_PROPERTY_HOST_CACHED_BIT)
+			.MapMemory()
+			.SetName("Image readback")
+			.SetCategory("Readback")
+			.Build(VK_BUFFER_USAGE_TRANSFER_DST_BIT, slotSize));
+}
+
+std::optional<uint64_t> vkc::ImageReadback::Record
+(
+	Context const&       context
+	, CommandBuffer&     commandBuffer
+	, Image const&       image
+	, uint32_t           mipLevel
+	, uint32_t           layer
+	, VkImageAspectFlags aspect
+)
+{
+	if (m_Recorded - m_Released == m_Slots.size())
+		return std::nullopt;
+
+	// a copy moves exactly one aspect
+	if (aspect == 0)
+		aspect = image.GetAspect();
+	assert(std::has_single_bit(aspect) && (aspect & image.GetAspect()));
+
+	Slot& slot = m_Slots[m_Recorded % m_Slots.size()];
+	slot.Extent = image.GetMipExtent(mipLevel);
+	slot.Format = image.GetFormat();
+	slot.Aspect = aspect;
+
+	VkDeviceSize const texelSize{ GetTexelSize(slot.Format, aspect) };
+	slot.Size = texelSize != 0
+				? texelSize * slot.Extent.width * slot.Extent.height
+				: TextureFile::CalculateSize(slot.Format, slot.Extent);
+	assert(slot.Size <= slot.Storage.GetSize());
+
+	// work recorded now belongs to the upcoming submission
+	slot.Owner      = &commandBuffer;
+	slot.Submission = commandBuffer.GetSubmissionCount() + 1;
+
+	VkBufferImageCopy2 region{};
+	region.sType                           = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2;
+	region.imageSubresource.aspectMask     = aspect;
+	region.imageSubresource.mipLevel       = mipLevel;
+	region.imageSubresource.baseArrayLayer = layer;
+	region.imageSubresource.layerCount     = 1;
+	region.imageExtent                     = { slot.Extent.width, slot.Extent.height, 1 };
+
+	VkCopyImageToBufferInfo2 info{};
+	info.sType          = VK_STRUCTURE_TYPE_COPY_IMAGE_TO_BUFFER_INFO_2;
+	info.srcImage       = image;
+	info.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	info.dstBuffer      = slot.Storage;
+	info.regionCount    = 1;
+	info.pRegions       = &region;
+	context.DispatchTable.cmdCopyImageToBuffer2(commandBuffer, &info);
+
+	// makes the copy available to the host once the submission completed
+	VkBufferMemoryBarrier2 barrier{};
+	barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+	barrier.srcStageMask        = VK_PIPELINE_STAGE_2_COPY_BIT;
+	barrier.srcAccessMask       = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	barrier.dstStageMask        = VK_PIPELINE_STAGE_2_HOST_BIT;
+	barrier.dstAccessMask       = VK_ACCESS_2_HOST_READ_BIT;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer              = slot.Storage;
+	barrier.size                = slot.Size;
+
+	VkDependencyInfo dependencyInfo{};
+	dependencyInfo.sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dependencyInfo.bufferMemoryBarrierCount = 1;
+	dependencyInfo.pBufferMemoryBarriers    = &barrier;
+	context.DispatchTable.cmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+
+	return m_Recorded++;
+}
+
+std::optional<vkc::ImageReadback::Frame> vkc::ImageReadback::Poll(Context const& context)
+{
+	if (m_Recorded == m_Released)
+		return std::nullopt;
+
+	Slot const& slot = m_Slots[m_Released % m_Slots.size()];
+	if (!slot.Owner->HasCompleted(context, slot.Submission))
+		return std::nullopt;
+
+	slot.Storage.Invalidate(context, 0, slot.Size);
+	return Frame{ slot.Storage.GetMappedData(), slot.Size, slot.Extent, slot.Format, slot.Aspect, m_Released };
+}
+
+void vkc::ImageReadback::Release()
+{
+	assert(m_Released < m_Recorded);
+
+	++m_Released;
+}
+
+VkDeviceSize vkc::ImageReadback::GetTexelSize(VkFormat format, VkImageAspectFlags aspect)
+{
+	// stencil is always copied as one byte per texel, depth as its own packed size
+	if (aspect == VK_IMAGE_ASPECT_STENCIL_BIT)
+		return 1;
+
+	switch (format)
+	{
+		case VK_FORMAT_R8_UNORM:
+		case VK_FORMAT_R8_SNORM:
+		case VK_FORMAT_R8_UINT:
+		case VK_FORMAT_R8_SINT:
+		case VK_FORMAT_R8_SRGB:
+		case VK_FORMAT_S8_UINT:
+			return 1;
+		case VK_FORMAT_R5G6B5_UNORM_PACK16:
+		case VK_FORMAT_B5G6R5_UNORM_PACK16:
+		case VK_FORMAT_R8G8_UNORM:
+		case VK_FORMAT_R8G8_SNORM:
+		case VK_FORMAT_R8G8_UINT:
+		case VK_FORMAT_R8G8_SINT:
+		case VK_FORMAT_R16_UNORM:
+		case VK_FORMAT_R16_SNORM:
+		case VK_FORMAT_R16_UINT:
+		case VK_FORMAT_R16_SINT:
+		case VK_FORMAT_R16_SFLOAT:
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+			return 2;
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SNORM:
+		case VK_FORMAT_R8G8B8A8_UINT:
+		case VK_FORMAT_R8G8B8A8_SINT:
+		case VK_FORMAT_R8G8B8A8_SRGB:
+		case VK_FORMAT_B8G8R8A8_UNORM:
+		case VK_FORMAT_B8G8R8A8_SRGB:
+		case VK_FORMAT_A8B8G8R8_UNORM_PACK32:
+		case VK_FORMAT_A8B8G8R8_SRGB_PACK32:
+		case VK_FORMAT_A2R10G10B10_UNORM_PACK32:
+		case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+		case VK_FORMAT_A2B10G10R10_UINT_PACK32:
+		case VK_FORMAT_R16G16_UNORM:
+		case VK_FORMAT_R16G16_SNORM:
+		case VK_FORMAT_R16G16_UINT:
+		case VK_FORMAT_R16G16_SINT:
+		case VK_FORMAT_R16G16_SFLOAT:
+		case VK_FORMAT_R32_UINT:
+		case VK_FORMAT_R32_SINT:
+		case VK_FORMAT_R32_SFLOAT:
+		case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+		case VK_FORMAT_E5B9G9R9_UFLOAT_PACK32:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return 4;
+		case VK_FORMAT_R16G16B16A16_UNORM:
+		case VK_FORMAT_R16G16B16A16_SNORM:
+		case VK_FORMAT_R16G16B16A16_UINT:
+		case VK_FORMAT_R16G16B16A16_SINT:
+		case VK_FORMAT_R16G16B16A16_SFLOAT:
+		case VK_FORMAT_R32G32_UINT:
+		case VK_FORMAT_R32G32_SINT:
+		case VK_FORMAT_R32G32_SFLOAT:
+		case VK_FORMAT_R64_UINT:
+		case VK_FORMAT_R64_SFLOAT:
+			return 8;
+		case VK_FORMAT_R32G32B32_UINT:
+		case VK_FORMAT_R32G32B32_SINT:
+		case VK_FORMAT_R32G32B32_SFLOAT:
+			return 12;
+		case VK_FORMAT_R32G32B32A32_UINT:
+		case VK_FORMAT_R32G32B32A32_SINT:
+		case VK_FORMAT_R32G32B32A32_SFLOAT:
+			return 16;
+		default:
+			return 0;
+	}
+}
@@ -0,0 +1,78 @@
+#include "mapped_file.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+vkc::MappedFile::MappedFile(std::filesystem::path const& path)
+{
+	m_Size = std::filesystem::file_size(path);
+	if (m_Size == 0)
+		throw std::runtime_error("Failed to map empty file " + path.string());
+
+#ifdef _WIN32
+	HANDLE const file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("Failed to open file " + path.string());
+
+	m_Mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	// mapping keeps its own reference to the file
+	CloseHandle(file);
+	if (!m_Mapping)
+		throw std::runtime_error("Failed to create file mapping of " + path.string());
+
+	m_Data = MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!m_Data)
+	{
+		CloseHandle(m_Mapping);
+		throw std::runtime_error("Failed to map file " + path.string());
+	}
+#else
+	int const file = open(path.c_str(), O_RDONLY);
+	if (file == -1)
+		throw std::runtime_error("Failed to open file " + path.string());
+
+	m_Data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (m_Data == MAP_FAILED)
+		throw std::runtime_error("Failed to map file " + path.string());
+
+	// contents are consumed front to back exactly once
+	madvise(m_Data, m_Size, MADV_SEQUENTIAL);
+#endif
+}
+
+vkc::MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	UnmapViewOfFile(m_Data);
+	CloseHandle(m_Mapping);
+#else
+	munmap(m_Data, m_Size);
+#endif
+}
+
+size_t vkc::MappedFile::GetPageSize()
+{
+	static size_t const pageSize{
+		[]
+		{
+#ifdef _WIN32
+			SYSTEM_INFO systemInfo{};
+			GetSystemInfo(&systemInfo);
+			return static_cast<size_t>(systemInfo.dwPageSize);
+#else
+			return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+		}()
+	};
+	return pageSize;
+}
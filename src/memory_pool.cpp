@@ -0,0 +1,110 @@
+#include "memory_pool.h"
+
+void vkc::MemoryPool::Destroy(Context const& context) const
+{
+	vmaDestroyPool(context.Allocator, m_Pool);
+}
+
+vkc::MemoryPoolBuilder::MemoryPoolBuilder(Context& context)
+	: m_Context{ context }
+{
+	m_AllocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+}
+
+vkc::MemoryPoolBuilder& vkc::MemoryPoolBuilder::SetMemoryUsage(VmaMemoryUsage memoryUsage)
+{
+	m_AllocationCreateInfo.usage = memoryUsage;
+	return *this;
+}
+
+vkc::MemoryPoolBuilder& vkc::MemoryPoolBuilder::SetRequiredMemoryFlags(VkMemoryPropertyFlags flags)
+{
+	m_AllocationCreateInfo.requiredFlags = flags;
+	return *this;
+}
+
+vkc::MemoryPoolBuilder& vkc::MemoryPoolBuilder::SetAllocationFlags(VmaAllocationCreateFlags flags)
+{
+	m_AllocationCreateInfo.flags = flags;
+	return *this;
+}
+
+vkc::MemoryPoolBuilder& vkc::MemoryPoolBuilder::SetBlockSize(VkDeviceSize blockSize)
+{
+	m_PoolCreateInfo.blockSize = blockSize;
+	return *this;
+}
+
+vkc::MemoryPoolBuilder& vkc::MemoryPoolBuilder::SetBlockCount(size_t minBlockCount, size_t maxBlockCount)
+{
+	m_PoolCreateInfo.minBlockCount = minBlockCount;
+	m_PoolCreateInfo.maxBlockCount = maxBlockCount;
+	return *this;
+}
+
+vkc::MemoryPoolBuilder& vkc::MemoryPoolBuilder::UseLinearAlgorithm(bool enable)
+{
+	if (enable)
+		m_PoolCreateInfo.flags |= VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT;
+	else
+		m_PoolCreateInfo.flags &= ~VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT;
+	return *this;
+}
+
+vkc::MemoryPool vkc::MemoryPoolBuilder::BuildForBuffers(VkBufferUsageFlags usage, bool addToQueue) const
+{
+	// size does not matter for choosing the memory type
+	VkBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.size        = 1024;
+	bufferCreateInfo.usage       = usage;
+	bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	uint32_t memoryTypeIndex{};
+	if (vmaFindMemoryTypeIndexForBufferInfo(m_Context.Allocator, &bufferCreateInfo, &m_AllocationCreateInfo, &memoryTypeIndex) != VK_SUCCESS)
+		throw std::runtime_error("Failed to find memory type for buffer pool");
+
+	return Build(memoryTypeIndex, addToQueue);
+}
+
+vkc::MemoryPool vkc::MemoryPoolBuilder::BuildForImages(VkImageUsageFlags usage, VkFormat format, VkImageTiling tiling, bool addToQueue) const
+{
+	VkImageCreateInfo imageCreateInfo{};
+	imageCreateInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageCreateInfo.imageType     = VK_IMAGE_TYPE_2D;
+	imageCreateInfo.format        = format;
+	imageCreateInfo.extent        = VkExtent3D{ 256, 256, 1 };
+	imageCreateInfo.mipLevels     = 1;
+	imageCreateInfo.arrayLayers   = 1;
+	imageCreateInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+	imageCreateInfo.tiling        = tiling;
+	imageCreateInfo.usage         = usage;
+	imageCreateInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+	imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	uint32_t memoryTypeIndex{};
+	if (vmaFindMemoryTypeIndexForImageInfo(m_Context.Allocator, &imageCreateInfo, &m_AllocationCreateInfo, &memoryTypeIndex) != VK_SUCCESS)
+		throw std::runtime_error("Failed to find memory type for image pool");
+
+	return Build(memoryTypeIndex, addToQueue);
+}
+
+vkc::MemoryPool vkc::MemoryPoolBuilder::Build(uint32_t memoryTypeIndex, bool addToQueue) const
+{
+	MemoryPool pool{};
+	pool.m_MemoryTypeIndex = memoryTypeIndex;
+
+	VmaPoolCreateInfo poolCreateInfo{ m_PoolCreateInfo };
+	poolCreateInfo.memoryTypeIndex = memoryTypeIndex;
+
+	if (vmaCreatePool(m_Context.Allocator, &poolCreateInfo, &pool.m_Pool) != VK_SUCCESS)
+		throw std::runtime_error("Failed to create memory pool");
+
+	if (addToQueue)
+		m_Context.DeletionQueue.Push([context = &m_Context, pool = pool.m_Pool]
+		{
+			vmaDestroyPool(context->Allocator, pool);
+		});
+
+	return pool;
+}
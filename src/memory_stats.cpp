@@ -0,0 +1,111 @@
+#include "memory_stats.h"
+
+#include <sstream>
+
+void vkc::MemoryStats::Track(VmaAllocator allocator, VmaAllocation allocation, std::string const& category)
+{
+	VmaAllocationInfo allocationInfo{};
+	vmaGetAllocationInfo(allocator, allocation, &allocationInfo);
+
+	std::string const& name{ category.empty() ? DefaultCategory : category };
+	m_CategoryBytes[name] += allocationInfo.size;
+	m_Allocations.insert_or_assign(allocation, Entry{ name, allocationInfo.size });
+}
+
+void vkc::MemoryStats::Untrack(VmaAllocation allocation)
+{
+	auto const it = m_Allocations.find(allocation);
+	if (it == m_Allocations.end())
+		return;
+
+	m_CategoryBytes[it->second.Category] -= it->second.Size;
+	m_Allocations.erase(it);
+}
+
+VkDeviceSize vkc::MemoryStats::GetCategoryBytes(std::string const& category) const
+{
+	auto const it = m_CategoryBytes.find(category);
+	return it != m_CategoryBytes.end() ? it->second : 0;
+}
+
+std::vector<vkc::MemoryStats::HeapBudget> vkc::MemoryStats::GetHeapBudgets(VmaAllocator allocator)
+{
+	VkPhysicalDeviceMemoryProperties const* memoryProperties{};
+	vmaGetMemoryProperties(allocator, &memoryProperties);
+
+	std::vector<VmaBudget> budgets(memoryProperties->memoryHeapCount);
+	vmaGetHeapBudgets(allocator, budgets.data());
+
+	std::vector<HeapBudget> heapBudgets;
+	heapBudgets.reserve(budgets.size());
+	for (uint32_t heap{ 0 }; heap < memoryProperties->memoryHeapCount; ++heap)
+		heapBudgets.emplace_back(HeapBudget{
+			budgets[heap].usage
+			, budgets[heap].budget
+			, budgets[heap].statistics.allocationBytes
+			, budgets[heap].statistics.blockBytes
+			, budgets[heap].statistics.allocationCount
+			, memoryProperties->memoryHeaps[heap].flags
+		});
+	return heapBudgets;
+}
+
+bool vkc::MemoryStats::IsOverBudget(VmaAllocator allocator, float threshold)
+{
+	for (HeapBudget const& heap: GetHeapBudgets(allocator))
+		if (static_cast<float>(heap.Usage) > static_cast<float>(heap.Budget) * threshold)
+			return true;
+	return false;
+}
+
+std::string vkc::MemoryStats::DumpJson(VmaAllocator allocator, bool detailedMap) const
+{
+	std::ostringstream json;
+
+	// category names come from code, only quotes and backslashes need escaping
+	auto const writeString = [&json](std::string const& string)
+	{
+		json << '"';
+		for (char const c: string)
+		{
+			if (c == '"' || c == '\\')
+				json << '\\';
+			json << c;
+		}
+		json << '"';
+	};
+
+	json << "{\"categories\":{";
+	bool first{ true };
+	for (auto const& [category, bytes]: m_CategoryBytes)
+	{
+		if (!first)
+			json << ',';
+		first = false;
+		writeString(category);
+		json << ':' << bytes;
+	}
+
+	json << "},\"heaps\":[";
+	first = true;
+	for (HeapBudget const& heap: GetHeapBudgets(allocator))
+	{
+		if (!first)
+			json << ',';
+		first = false;
+		json << "{\"usage\":" << heap.Usage
+			<< ",\"budget\":" << heap.Budget
+			<< ",\"allocationBytes\":" << heap.AllocationBytes
+			<< ",\"blockBytes\":" << heap.BlockBytes
+			<< ",\"allocationCount\":" << heap.AllocationCount
+			<< ",\"deviceLocal\":" << ((heap.Flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? "true" : "false")
+			<< '}';
+	}
+
+	char* vmaStats{};
+	vmaBuildStatsString(allocator, &vmaStats, detailedMap ? VK_TRUE : VK_FALSE);
+	json << "],\"vma\":" << vmaStats << '}';
+	vmaFreeStatsString(allocator, vmaStats);
+
+	return json.str();
+}
@@ -0,0 +1,44 @@
+#include "offscreen_swapchain.h"
+
+vkc::OffscreenSwapchain::OffscreenSwapchain
+(
+	Context&            context
+	, uint32_t          imageCount
+	, VkExtent2D        extent
+	, VkFormat          format
+	, VkImageUsageFlags usage
+)
+	: m_InFlight(imageCount)
+{
+	assert(imageCount > 0);
+
+	m_Images.reserve(imageCount);
+	for (uint32_t i{ 0 }; i < imageCount; ++i)
+		m_Images.push_back(
+			ImageBuilder{ context }
+			.SetFormat(format)
+			.SetExtent(extent)
+			.SetType(VK_IMAGE_TYPE_2D)
+			.SetName("Offscreen swapchain image")
+			.SetCategory("Swapchain")
+			.Build(usage));
+}
+
+std::optional<uint32_t> vkc::OffscreenSwapchain::AcquireNextImage(Context const& context)
+{
+	InFlight& inFlight = m_InFlight[m_Next];
+	if (inFlight.Owner && !inFlight.Owner->HasCompleted(context, inFlight.Submission))
+		return std::nullopt;
+
+	inFlight = {};
+	uint32_t const imageIndex{ m_Next };
+	m_Next = (m_Next + 1) % GetImageCount();
+	return imageIndex;
+}
+
+void vkc::OffscreenSwapchain::Present(uint32_t imageIndex, CommandBuffer& commandBuffer)
+{
+	assert(commandBuffer.GetSubmissionCount() > 0);
+
+	m_InFlight[imageIndex] = { &commandBuffer, commandBuffer.GetSubmissionCount() };
+}
@@ -0,0 +1,118 @@
+#include "parallel_recorder.h"
+
+vkc::ParallelRecorder::ParallelRecorder(Context& context, uint32_t queueIndex, uint32_t workerCount, uint32_t framesInFlight)
+	: m_Secondaries(workerCount)
+	, m_Errors(workerCount)
+{
+	assert(workerCount > 0 && framesInFlight > 0);
+
+	// buffers are reset together with their pool every frame
+	for (uint32_t i{ 0 }; i < workerCount * framesInFlight; ++i)
+		m_Pools.emplace_back(context, queueIndex, 1, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+	m_Workers.reserve(workerCount);
+	for (uint32_t worker{ 0 }; worker < workerCount; ++worker)
+		m_Workers.emplace_back([this, worker](std::stop_token const& stopToken) { Work(stopToken, worker); });
+}
+
+void vkc::ParallelRecorder::BeginFrame(Context const& context, uint32_t frame)
+{
+	assert(frame < m_Pools.size() / m_Workers.size());
+
+	m_Frame = frame;
+	for (uint32_t worker{ 0 }; worker < m_Workers.size(); ++worker)
+		m_Pools[frame * m_Workers.size() + worker].Reset(context);
+}
+
+void vkc::ParallelRecorder::Record
+(
+	Context&                                          context
+	, VkCommandBuffer                                 primary
+	, VkCommandBufferInheritanceRenderingInfo const& renderingInfo
+	, uint32_t                                        taskCount
+	, RecordFunction const&                           record
+)
+{
+	if (taskCount == 0)
+		return;
+
+	// more workers than tasks would only record empty secondaries
+	uint32_t const workerCount{ std::min(taskCount, static_cast<uint32_t>(m_Workers.size())) };
+	for (uint32_t worker{ 0 }; worker < m_Workers.size(); ++worker)
+		m_Secondaries[worker] = worker < workerCount
+								? &m_Pools[m_Frame * m_Workers.size() + worker].AllocateCommandBuffer(context)
+								: nullptr;
+
+	{
+		std::scoped_lock lock{ m_Mutex };
+		m_Context       = &context;
+		m_RenderingInfo = &renderingInfo;
+		m_Record        = &record;
+		m_TaskCount     = taskCount;
+		m_ActiveWorkers = workerCount;
+		m_Remaining     = static_cast<uint32_t>(m_Workers.size());
+		++m_Generation;
+	}
+	m_Start.notify_all();
+
+	{
+		std::unique_lock lock{ m_Mutex };
+		m_Done.wait(lock, [this] { return m_Remaining == 0; });
+	}
+
+	// every error is taken out so none of them resurfaces in a later Record
+	std::exception_ptr firstError;
+	for (std::exception_ptr& error: m_Errors)
+	{
+		if (!firstError)
+			firstError = error;
+		error = nullptr;
+	}
+	if (firstError)
+		std::rethrow_exception(firstError);
+
+	std::vector<VkCommandBuffer> secondaries(workerCount);
+	for (uint32_t worker{ 0 }; worker < workerCount; ++worker)
+		secondaries[worker] = *m_Secondaries[worker];
+	context.DispatchTable.cmdExecuteCommands(primary, workerCount, secondaries.data());
+}
+
+void vkc::ParallelRecorder::Work(std::stop_token const& stopToken, uint32_t worker)
+{
+	uint64_t generation{ 0 };
+	while (true)
+	{
+		{
+			std::unique_lock lock{ m_Mutex };
+			if (!m_Start.wait(lock, stopToken, [this, generation] { return m_Generation != generation; }))
+				return;
+			generation = m_Generation;
+		}
+
+		// contiguous ranges keep the order of the tasks when the secondaries are executed in worker order
+		if (CommandBuffer* secondary = m_Secondaries[worker])
+		{
+			try
+			{
+				uint32_t const first{ static_cast<uint32_t>(uint64_t{ m_TaskCount } * worker / m_ActiveWorkers) };
+				uint32_t const last{ static_cast<uint32_t>(uint64_t{ m_TaskCount } * (worker + 1) / m_ActiveWorkers) };
+
+				secondary->BeginSecondary(*m_Context, *m_RenderingInfo, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+				for (uint32_t task{ first }; task < last; ++task)
+					(*m_Record)(*m_Context, *secondary, task);
+				secondary->End(*m_Context);
+			}
+			catch (...)
+			{
+				m_Errors[worker] = std::current_exception();
+			}
+		}
+
+		{
+			std::scoped_lock lock{ m_Mutex };
+			if (--m_Remaining != 0)
+				continue;
+		}
+		m_Done.notify_one();
+	}
+}
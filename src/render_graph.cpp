@@ -0,0 +1,377 @@
+#include "render_graph.h"
+
+vkc::RenderGraph::Pass& vkc::RenderGraph::Pass::Read(ImageHandle image, Access const& access)
+{
+	return Use(image.Index, true, false, access);
+}
+
+vkc::RenderGraph::Pass& vkc::RenderGraph::Pass::Write(ImageHandle image, Access const& access)
+{
+	return Use(image.Index, true, true, access);
+}
+
+vkc::RenderGraph::Pass& vkc::RenderGraph::Pass::Read(BufferHandle buffer, Access const& access)
+{
+	return Use(buffer.Index, false, false, access);
+}
+
+vkc::RenderGraph::Pass& vkc::RenderGraph::Pass::Write(BufferHandle buffer, Access const& access)
+{
+	return Use(buffer.Index, false, true, access);
+}
+
+vkc::RenderGraph::Pass& vkc::RenderGraph::Pass::SetSideEffects(bool sideEffects)
+{
+	m_SideEffects = sideEffects;
+	return *this;
+}
+
+vkc::RenderGraph::Pass& vkc::RenderGraph::Pass::SetRecord(RecordFunction record)
+{
+	m_Record = std::move(record);
+	return *this;
+}
+
+vkc::RenderGraph::Pass& vkc::RenderGraph::Pass::Use(uint32_t resource, bool isImage, bool isWrite, Access const& access)
+{
+	auto const existing = std::ranges::find_if(m_Uses, [resource, isImage](ResourceUse const& use)
+	{
+		return use.Resource == resource && use.IsImage == isImage;
+	});
+
+	if (existing == m_Uses.end())
+	{
+		m_Uses.emplace_back(resource, isImage, !isWrite, isWrite, access);
+		return *this;
+	}
+
+	assert(existing->Access.Layout == access.Layout);
+	existing->IsRead = existing->IsRead || !isWrite;
+	existing->IsWrite = existing->IsWrite || isWrite;
+	existing->Access.StageMask |= access.StageMask;
+	existing->Access.AccessMask |= access.AccessMask;
+	return *this;
+}
+
+vkc::RenderGraph::ImageHandle vkc::RenderGraph::ImportImage(Image& image)
+{
+	assert(!m_Compiled);
+
+	ImageResource& resource = m_Images.emplace_back();
+	resource.Imported = &image;
+	return { static_cast<uint32_t>(m_Images.size() - 1) };
+}
+
+vkc::RenderGraph::BufferHandle vkc::RenderGraph::ImportBuffer(Buffer& buffer)
+{
+	assert(!m_Compiled);
+
+	BufferResource& resource = m_Buffers.emplace_back();
+	resource.Imported = &buffer;
+	return { static_cast<uint32_t>(m_Buffers.size() - 1) };
+}
+
+vkc::RenderGraph::ImageHandle vkc::RenderGraph::CreateImage(ImageDescription const& description)
+{
+	assert(!m_Compiled);
+
+	ImageResource& resource = m_Images.emplace_back();
+	resource.Description = description;
+	return { static_cast<uint32_t>(m_Images.size() - 1) };
+}
+
+vkc::RenderGraph::BufferHandle vkc::RenderGraph::CreateBuffer(BufferDescription const& description)
+{
+	assert(!m_Compiled && description.Size > 0);
+
+	BufferResource& resource = m_Buffers.emplace_back();
+	resource.Description = description;
+	return { static_cast<uint32_t>(m_Buffers.size() - 1) };
+}
+
+vkc::RenderGraph::Pass& vkc::RenderGraph::AddPass(std::string name)
+{
+	assert(!m_Compiled);
+
+	m_Passes.push_back(Pass{ std::move(name) });
+	return m_Passes.back();
+}
+
+void vkc::RenderGraph::Compile(Context& context, bool addToQueue)
+{
+	assert(!m_Compiled);
+
+	CullAndOrder();
+	CreateTransientResources(context, addToQueue);
+	m_Compiled = true;
+}
+
+void vkc::RenderGraph::Execute(Context const& context, VkCommandBuffer commandBuffer)
+{
+	assert(m_Compiled);
+
+	BarrierBatch barriers{};
+	for (uint32_t step{ 0 }; step < m_Steps.size(); ++step)
+	{
+		// the memory was used by aliased resources since the last execution
+		for (ImageResource const& resource: m_Images)
+			if (resource.Transient != NoIndex && resource.FirstStep == step)
+				m_TransientImages[resource.Transient].Discard(m_Allocator.GetAliasedState(resource.Allocation));
+		for (BufferResource const& resource: m_Buffers)
+			if (resource.Transient != NoIndex && resource.FirstStep == step)
+				m_TransientBuffers[resource.Transient].Discard(m_Allocator.GetAliasedState(resource.Allocation));
+
+		for (uint32_t const pass: m_Steps[step])
+			for (Pass::ResourceUse const& use: m_Passes[pass].m_Uses)
+			{
+				if (use.IsImage)
+					barriers.Require(GetImage({ use.Resource }), use.Access);
+				else
+					barriers.Require(GetBuffer({ use.Resource }), use.Access);
+			}
+		barriers.Flush(context, commandBuffer);
+
+		for (uint32_t const pass: m_Steps[step])
+			if (m_Passes[pass].m_Record)
+				m_Passes[pass].m_Record(context, commandBuffer, *this);
+	}
+}
+
+void vkc::RenderGraph::Destroy(Context const& context) const
+{
+	for (Image const& image: m_TransientImages)
+		image.Destroy(context);
+	for (Buffer const& buffer: m_TransientBuffers)
+		buffer.Destroy(context);
+	m_Allocator.Destroy(context);
+}
+
+vkc::Image& vkc::RenderGraph::GetImage(ImageHandle image)
+{
+	ImageResource const& resource = m_Images[image.Index];
+	if (resource.Imported)
+		return *resource.Imported;
+
+	// unused transient images are never created
+	assert(resource.Transient != NoIndex);
+	return m_TransientImages[resource.Transient];
+}
+
+vkc::Buffer& vkc::RenderGraph::GetBuffer(BufferHandle buffer)
+{
+	BufferResource const& resource = m_Buffers[buffer.Index];
+	if (resource.Imported)
+		return *resource.Imported;
+
+	assert(resource.Transient != NoIndex);
+	return m_TransientBuffers[resource.Transient];
+}
+
+VkImageUsageFlags vkc::RenderGraph::GetImageUsage(Access const& access)
+{
+	VkImageUsageFlags usage{};
+	if (access.AccessMask & (VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT))
+		usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+	if (access.AccessMask & (VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT))
+		usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+	if (access.AccessMask & VK_ACCESS_2_INPUT_ATTACHMENT_READ_BIT)
+		usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+	if (access.AccessMask & VK_ACCESS_2_SHADER_SAMPLED_READ_BIT)
+		usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+	if (access.AccessMask & (VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_SHADER_WRITE_BIT))
+		usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+	if (access.AccessMask & VK_ACCESS_2_TRANSFER_READ_BIT)
+		usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	if (access.AccessMask & VK_ACCESS_2_TRANSFER_WRITE_BIT)
+		usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+	// the legacy umbrella bit only tells through the layout whether it's a storage image
+	if (access.AccessMask & VK_ACCESS_2_SHADER_READ_BIT)
+		usage |= access.Layout == VK_IMAGE_LAYOUT_GENERAL ? VK_IMAGE_USAGE_STORAGE_BIT : VK_IMAGE_USAGE_SAMPLED_BIT;
+	return usage;
+}
+
+VkBufferUsageFlags vkc::RenderGraph::GetBufferUsage(Access const& access)
+{
+	VkBufferUsageFlags usage{};
+	if (access.AccessMask & VK_ACCESS_2_UNIFORM_READ_BIT)
+		usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+	if (access.AccessMask & (VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT
+							 | VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT))
+		usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+	if (access.AccessMask & VK_ACCESS_2_INDEX_READ_BIT)
+		usage |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+	if (access.AccessMask & VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT)
+		usage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+	if (access.AccessMask & VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+		usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+	if (access.AccessMask & VK_ACCESS_2_TRANSFER_READ_BIT)
+		usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	if (access.AccessMask & VK_ACCESS_2_TRANSFER_WRITE_BIT)
+		usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	return usage;
+}
+
+void vkc::RenderGraph::CullAndOrder()
+{
+	auto const passCount  = static_cast<uint32_t>(m_Passes.size());
+	auto const imageCount = static_cast<uint32_t>(m_Images.size());
+
+	// per resource, images first, the last writer and the readers of its contents in declaration order
+	struct History
+	{
+		uint32_t                                        LastWriter{ NoIndex };
+		std::vector<std::pair<uint32_t, VkImageLayout>> Readers;
+	};
+	std::vector<History> histories(imageCount + m_Buffers.size());
+
+	// every edge points to a later pass, producers are the passes whose writes are read
+	std::vector<std::vector<uint32_t>> successors(passCount);
+	std::vector<std::vector<uint32_t>> producers(passCount);
+	std::vector<uint32_t>              pending;
+
+	for (uint32_t pass{ 0 }; pass < passCount; ++pass)
+	{
+		bool isOutput{ m_Passes[pass].m_SideEffects };
+		for (Pass::ResourceUse const& use: m_Passes[pass].m_Uses)
+		{
+			History& history = histories[use.IsImage ? use.Resource : imageCount + use.Resource];
+
+			if (history.LastWriter != NoIndex)
+			{
+				successors[history.LastWriter].push_back(pass);
+				if (use.IsRead)
+					producers[pass].push_back(history.LastWriter);
+			}
+
+			if (use.IsWrite)
+			{
+				// previous contents must be read before they are overwritten
+				for (auto const& [reader, layout]: history.Readers)
+					successors[reader].push_back(pass);
+
+				history.LastWriter = pass;
+				history.Readers.clear();
+				isOutput = isOutput || (use.IsImage ? m_Images[use.Resource].Imported != nullptr : m_Buffers[use.Resource].Imported != nullptr);
+			}
+			else
+			{
+				// readers in different layouts can't share a barrier batch
+				for (auto const& [reader, layout]: history.Readers)
+					if (layout != use.Access.Layout)
+						successors[reader].push_back(pass);
+				history.Readers.emplace_back(pass, use.Access.Layout);
+			}
+		}
+
+		if (isOutput)
+			pending.push_back(pass);
+	}
+
+	// everything contributing to an output survives
+	std::vector<bool> isNeeded(passCount, false);
+	for (uint32_t const pass: pending)
+		isNeeded[pass] = true;
+	while (!pending.empty())
+	{
+		uint32_t const pass{ pending.back() };
+		pending.pop_back();
+		for (uint32_t const producer: producers[pass])
+			if (!isNeeded[producer])
+			{
+				isNeeded[producer] = true;
+				pending.push_back(producer);
+			}
+	}
+
+	// Kahn's algorithm one level at a time, a level only depends on earlier levels
+	std::vector<uint32_t> inDegrees(passCount, 0);
+	for (uint32_t pass{ 0 }; pass < passCount; ++pass)
+		if (isNeeded[pass])
+			for (uint32_t const successor: successors[pass])
+				inDegrees[successor] += isNeeded[successor] ? 1 : 0;
+
+	std::vector<uint32_t> ready;
+	for (uint32_t pass{ 0 }; pass < passCount; ++pass)
+	{
+		m_Passes[pass].m_Culled = !isNeeded[pass];
+		if (isNeeded[pass] && inDegrees[pass] == 0)
+			ready.push_back(pass);
+	}
+
+	while (!ready.empty())
+	{
+		std::vector<uint32_t> next;
+		for (uint32_t const pass: ready)
+			for (uint32_t const successor: successors[pass])
+				if (isNeeded[successor] && --inDegrees[successor] == 0)
+					next.push_back(successor);
+
+		// declaration order within a level keeps recording deterministic
+		std::ranges::sort(next);
+		m_Steps.push_back(std::move(ready));
+		ready = std::move(next);
+	}
+
+	for (uint32_t step{ 0 }; step < m_Steps.size(); ++step)
+		for (uint32_t const pass: m_Steps[step])
+			for (Pass::ResourceUse const& use: m_Passes[pass].m_Uses)
+			{
+				auto const extendLifetime = [step](auto& resource)
+				{
+					resource.FirstStep = std::min(resource.FirstStep, step);
+					resource.LastStep  = std::max(resource.LastStep, step);
+				};
+
+				if (use.IsImage)
+				{
+					extendLifetime(m_Images[use.Resource]);
+					m_Images[use.Resource].Usage |= GetImageUsage(use.Access);
+				}
+				else
+				{
+					extendLifetime(m_Buffers[use.Resource]);
+					m_Buffers[use.Resource].Usage |= GetBufferUsage(use.Access);
+				}
+			}
+}
+
+void vkc::RenderGraph::CreateTransientResources(Context& context, bool addToQueue)
+{
+	// reserved up front, the allocator keeps pointers to the resources
+	m_TransientImages.reserve(m_Images.size());
+	m_TransientBuffers.reserve(m_Buffers.size());
+
+	for (ImageResource& resource: m_Images)
+	{
+		if (resource.Imported || resource.FirstStep == NoIndex)
+			continue;
+
+		ImageDescription const& description = resource.Description;
+		resource.Transient = static_cast<uint32_t>(m_TransientImages.size());
+		m_TransientImages.push_back(
+			ImageBuilder{ context }
+			.SetFormat(description.Format)
+			.SetExtent(description.Extent)
+			.SetAspectFlags(description.AspectFlags)
+			.SetLayers(description.Layers)
+			.SetMipLevels(description.MipLevels)
+			.SetType(VK_IMAGE_TYPE_2D)
+			.BuildAliased(resource.Usage | description.Usage, addToQueue));
+		resource.Allocation = m_Allocator.Add(m_TransientImages.back(), { resource.FirstStep, resource.LastStep });
+	}
+
+	for (BufferResource& resource: m_Buffers)
+	{
+		if (resource.Imported || resource.FirstStep == NoIndex)
+			continue;
+
+		resource.Transient = static_cast<uint32_t>(m_TransientBuffers.size());
+		m_TransientBuffers.push_back(
+			BufferBuilder{ context }
+			.BuildAliased(resource.Usage | resource.Description.Usage, resource.Description.Size, addToQueue));
+		resource.Allocation = m_Allocator.Add(m_TransientBuffers.back(), { resource.FirstStep, resource.LastStep });
+	}
+
+	m_Allocator.Allocate(context, addToQueue);
+}
@@ -0,0 +1,178 @@
+#include "sampler.h"
+
+#include <bit>
+
+void vkc::Sampler::Destroy(Context const& context) const
+{
+	if (!m_Cached)
+		context.DispatchTable.destroySampler(m_Sampler, nullptr);
+}
+
+void vkc::SamplerCache::Destroy(Context const& context)
+{
+	for (auto const& [key, sampler]: m_Samplers)
+		context.DispatchTable.destroySampler(sampler, nullptr);
+	m_Samplers.clear();
+}
+
+bool vkc::SamplerCache::Key::operator==(Key const& other) const
+{
+	VkSamplerCreateInfo const& a = CreateInfo;
+	VkSamplerCreateInfo const& b = other.CreateInfo;
+
+	// floats compared bitwise to stay consistent with the hash
+	return a.flags == b.flags && a.magFilter == b.magFilter && a.minFilter == b.minFilter && a.mipmapMode == b.mipmapMode
+		&& a.addressModeU == b.addressModeU && a.addressModeV == b.addressModeV && a.addressModeW == b.addressModeW
+		&& std::bit_cast<uint32_t>(a.mipLodBias) == std::bit_cast<uint32_t>(b.mipLodBias)
+		&& a.anisotropyEnable == b.anisotropyEnable
+		&& std::bit_cast<uint32_t>(a.maxAnisotropy) == std::bit_cast<uint32_t>(b.maxAnisotropy)
+		&& a.compareEnable == b.compareEnable && a.compareOp == b.compareOp
+		&& std::bit_cast<uint32_t>(a.minLod) == std::bit_cast<uint32_t>(b.minLod)
+		&& std::bit_cast<uint32_t>(a.maxLod) == std::bit_cast<uint32_t>(b.maxLod)
+		&& a.borderColor == b.borderColor && a.unnormalizedCoordinates == b.unnormalizedCoordinates
+		&& ReductionMode == other.ReductionMode;
+}
+
+size_t vkc::SamplerCache::Hash::operator()(Key const& key) const
+{
+	VkSamplerCreateInfo const& info = key.CreateInfo;
+	uint64_t const fields[]{
+		info.flags,
+		static_cast<uint64_t>(info.magFilter) | static_cast<uint64_t>(info.minFilter) << 8 | static_cast<uint64_t>(info.mipmapMode) << 16
+		| static_cast<uint64_t>(info.addressModeU) << 24 | static_cast<uint64_t>(info.addressModeV) << 32
+		| static_cast<uint64_t>(info.addressModeW) << 40 | static_cast<uint64_t>(info.borderColor) << 48,
+		std::bit_cast<uint32_t>(info.mipLodBias) | static_cast<uint64_t>(std::bit_cast<uint32_t>(info.maxAnisotropy)) << 32,
+		std::bit_cast<uint32_t>(info.minLod) | static_cast<uint64_t>(std::bit_cast<uint32_t>(info.maxLod)) << 32,
+		info.anisotropyEnable | info.compareEnable << 1 | info.unnormalizedCoordinates << 2
+		| static_cast<uint64_t>(info.compareOp) << 8 | static_cast<uint64_t>(key.ReductionMode) << 16
+	};
+
+	size_t hash{ 0 };
+	for (uint64_t const field: fields)
+		hash ^= std::hash<uint64_t>{}(field) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+	return hash;
+}
+
+vkc::SamplerBuilder::SamplerBuilder(Context& context)
+	: m_Context{ context }
+{
+	m_CreateInfo.sType         = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	m_CreateInfo.magFilter     = VK_FILTER_LINEAR;
+	m_CreateInfo.minFilter     = VK_FILTER_LINEAR;
+	m_CreateInfo.mipmapMode    = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	m_CreateInfo.addressModeU  = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	m_CreateInfo.addressModeV  = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	m_CreateInfo.addressModeW  = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	m_CreateInfo.maxAnisotropy = 1.0f;
+	m_CreateInfo.compareOp     = VK_COMPARE_OP_ALWAYS;
+	m_CreateInfo.maxLod        = VK_LOD_CLAMP_NONE;
+	m_CreateInfo.borderColor   = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+}
+
+vkc::SamplerBuilder& vkc::SamplerBuilder::SetFilter(VkFilter magFilter, VkFilter minFilter)
+{
+	m_CreateInfo.magFilter = magFilter;
+	m_CreateInfo.minFilter = minFilter;
+	return *this;
+}
+
+vkc::SamplerBuilder& vkc::SamplerBuilder::SetMipmapMode(VkSamplerMipmapMode mipmapMode)
+{
+	m_CreateInfo.mipmapMode = mipmapMode;
+	return *this;
+}
+
+vkc::SamplerBuilder& vkc::SamplerBuilder::SetAddressMode(VkSamplerAddressMode u, VkSamplerAddressMode v, VkSamplerAddressMode w)
+{
+	m_CreateInfo.addressModeU = u;
+	m_CreateInfo.addressModeV = v;
+	m_CreateInfo.addressModeW = w;
+	return *this;
+}
+
+vkc::SamplerBuilder& vkc::SamplerBuilder::SetAddressMode(VkSamplerAddressMode addressMode)
+{
+	return SetAddressMode(addressMode, addressMode, addressMode);
+}
+
+vkc::SamplerBuilder& vkc::SamplerBuilder::SetLod(float minLod, float maxLod, float mipLodBias)
+{
+	m_CreateInfo.minLod     = minLod;
+	m_CreateInfo.maxLod     = maxLod;
+	m_CreateInfo.mipLodBias = mipLodBias;
+	return *this;
+}
+
+vkc::SamplerBuilder& vkc::SamplerBuilder::SetBorderColor(VkBorderColor borderColor)
+{
+	m_CreateInfo.borderColor = borderColor;
+	return *this;
+}
+
+vkc::SamplerBuilder& vkc::SamplerBuilder::SetUnnormalizedCoordinates(bool unnormalized)
+{
+	m_CreateInfo.unnormalizedCoordinates = unnormalized ? VK_TRUE : VK_FALSE;
+	return *this;
+}
+
+vkc::SamplerBuilder& vkc::SamplerBuilder::SetAnisotropy(float maxAnisotropy)
+{
+	float const limit{ m_Context.Device.physical_device.properties.limits.maxSamplerAnisotropy };
+	m_CreateInfo.maxAnisotropy    = std::clamp(maxAnisotropy, 1.0f, std::max(limit, 1.0f));
+	m_CreateInfo.anisotropyEnable = m_CreateInfo.maxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+	return *this;
+}
+
+vkc::SamplerBuilder& vkc::SamplerBuilder::SetCompareOp(VkCompareOp compareOp)
+{
+	m_CreateInfo.compareEnable = VK_TRUE;
+	m_CreateInfo.compareOp     = compareOp;
+	return *this;
+}
+
+vkc::SamplerBuilder& vkc::SamplerBuilder::SetReductionMode(VkSamplerReductionMode reductionMode)
+{
+	m_ReductionMode = reductionMode;
+	return *this;
+}
+
+vkc::SamplerBuilder& vkc::SamplerBuilder::UseCache(SamplerCache& cache)
+{
+	m_Cache = &cache;
+	return *this;
+}
+
+vkc::Sampler vkc::SamplerBuilder::Build(bool addToQueue) const
+{
+	Sampler sampler{};
+	sampler.m_Cached = m_Cache != nullptr;
+
+	SamplerCache::Key const key{ m_CreateInfo, m_ReductionMode };
+	if (m_Cache)
+		if (auto const cached = m_Cache->m_Samplers.find(key); cached != m_Cache->m_Samplers.end())
+		{
+			sampler.m_Sampler = cached->second;
+			return sampler;
+		}
+
+	// weighted average is what a sampler without the chained struct does anyway
+	VkSamplerReductionModeCreateInfo reductionModeCreateInfo{};
+	reductionModeCreateInfo.sType         = VK_STRUCTURE_TYPE_SAMPLER_REDUCTION_MODE_CREATE_INFO;
+	reductionModeCreateInfo.reductionMode = m_ReductionMode;
+
+	VkSamplerCreateInfo createInfo{ m_CreateInfo };
+	if (m_ReductionMode != VK_SAMPLER_REDUCTION_MODE_WEIGHTED_AVERAGE)
+		createInfo.pNext = &reductionModeCreateInfo;
+
+	if (m_Context.DispatchTable.createSampler(&createInfo, nullptr, &sampler.m_Sampler) != VK_SUCCESS)
+		throw std::runtime_error("Failed to create sampler");
+
+	if (m_Cache)
+		m_Cache->m_Samplers.emplace(key, sampler.m_Sampler);
+	else if (addToQueue)
+		m_Context.DeletionQueue.Push([context = &m_Context, sampler = sampler.m_Sampler]
+		{
+			context->DispatchTable.destroySampler(sampler, nullptr);
+		});
+	return sampler;
+}
@@ -0,0 +1,94 @@
+#include "staging_ring.h"
+
+vkc::StagingRing::StagingRing(Context& context, VkDeviceSize size)
+	: m_Buffer{
+		BufferBuilder{ context }
+		.SetRequiredMemoryFlags(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+		.MapMemory()
+		.Build(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, size)
+	} {}
+
+std::optional<vkc::StagingRing::Allocation> vkc::StagingRing::Allocate
+(Context const& context, CommandBuffer& commandBuffer, VkDeviceSize size, VkDeviceSize alignment)
+{
+	assert(size > 0 && size <= GetCapacity());
+
+	std::optional<VkDeviceSize> offset{ FindSpace(size, alignment) };
+	if (!offset)
+	{
+		Reclaim(context);
+		offset = FindSpace(size, alignment);
+		if (!offset)
+			return std::nullopt;
+	}
+
+	m_Head = *offset + size;
+
+	// work recorded now belongs to the upcoming submission
+	uint64_t const submission{ commandBuffer.GetSubmissionCount() + 1 };
+	if (!m_InFlight.empty() && m_InFlight.back().Owner == &commandBuffer && m_InFlight.back().Submission == submission)
+		m_InFlight.back().End = m_Head;
+	else
+		m_InFlight.emplace_back(&commandBuffer, submission, m_Head);
+
+	return Allocation{ *offset, size, static_cast<char*>(m_Buffer.GetMappedData()) + *offset };
+}
+
+void vkc::StagingRing::CopyTo
+(Context const& context, CommandBuffer const& commandBuffer, Allocation const& allocation, Buffer const& dst, VkDeviceSize dstOffset) const
+{
+	assert(dstOffset + allocation.Size <= dst.GetSize());
+
+	VkBufferCopy2 copyRegion{};
+	copyRegion.sType     = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
+	copyRegion.srcOffset = allocation.Offset;
+	copyRegion.dstOffset = dstOffset;
+	copyRegion.size      = allocation.Size;
+
+	VkCopyBufferInfo2 info{};
+	info.sType       = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+	info.srcBuffer   = m_Buffer;
+	info.dstBuffer   = dst;
+	info.regionCount = 1;
+	info.pRegions    = &copyRegion;
+
+	context.DispatchTable.cmdCopyBuffer2(commandBuffer, &info);
+}
+
+void vkc::StagingRing::Reclaim(Context const& context)
+{
+	while (!m_InFlight.empty() && m_InFlight.front().Owner->HasCompleted(context, m_InFlight.front().Submission))
+	{
+		m_Tail = m_InFlight.front().End;
+		m_InFlight.pop_front();
+	}
+
+	// nothing in flight, start over from the beginning to keep ranges contiguous
+	if (m_InFlight.empty())
+		m_Head = m_Tail = 0;
+}
+
+std::optional<VkDeviceSize> vkc::StagingRing::FindSpace(VkDeviceSize size, VkDeviceSize alignment) const
+{
+	VkDeviceSize const capacity{ GetCapacity() };
+	VkDeviceSize const offset{ (m_Head + alignment - 1) / alignment * alignment };
+
+	if (m_InFlight.empty())
+		return size <= capacity ? std::optional{ VkDeviceSize{ 0 } } : std::nullopt;
+
+	// free space is [head, capacity) followed by [0, tail)
+	if (m_Head > m_Tail)
+	{
+		if (offset + size <= capacity)
+			return offset;
+		// wrap around, skipped space at the end is released together with the range after it
+		if (size <= m_Tail)
+			return VkDeviceSize{ 0 };
+		return std::nullopt;
+	}
+
+	// free space is [head, tail), equal head and tail means the ring is full
+	if (offset + size <= m_Tail)
+		return offset;
+	return std::nullopt;
+}
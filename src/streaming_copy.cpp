@@ -0,0 +1,110 @@
+#include "streaming_copy.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VKC_STREAMING_SSE2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define VKC_TARGET_AVX2
+#else
+#define VKC_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#ifdef VKC_STREAMING_SSE2
+namespace
+{
+	// regular stores until dst is aligned for streaming stores, returns the bytes copied
+	size_t CopyHead(char* dst, char const* src, size_t size, size_t alignment)
+	{
+		size_t const head{ std::min(size, (alignment - reinterpret_cast<uintptr_t>(dst) % alignment) % alignment) };
+		memcpy(dst, src, head);
+		return head;
+	}
+
+	void StreamSse2(char* dst, char const* src, size_t size)
+	{
+		constexpr size_t vectorSize{ 16 };
+		size_t const     head{ CopyHead(dst, src, size, vectorSize) };
+		dst += head;
+		src += head;
+		size -= head;
+
+		for (; size >= 4 * vectorSize; size -= 4 * vectorSize, dst += 4 * vectorSize, src += 4 * vectorSize)
+		{
+			__m128i const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src));
+			__m128i const b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + vectorSize));
+			__m128i const c = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 2 * vectorSize));
+			__m128i const d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 3 * vectorSize));
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dst + vectorSize), b);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 2 * vectorSize), c);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 3 * vectorSize), d);
+		}
+		for (; size >= vectorSize; size -= vectorSize, dst += vectorSize, src += vectorSize)
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dst), _mm_loadu_si128(reinterpret_cast<__m128i const*>(src)));
+
+		// streaming stores are weakly ordered, make them visible before anything is submitted
+		_mm_sfence();
+		memcpy(dst, src, size);
+	}
+
+	VKC_TARGET_AVX2 void StreamAvx2(char* dst, char const* src, size_t size)
+	{
+		constexpr size_t vectorSize{ 32 };
+		size_t const     head{ CopyHead(dst, src, size, vectorSize) };
+		dst += head;
+		src += head;
+		size -= head;
+
+		for (; size >= 4 * vectorSize; size -= 4 * vectorSize, dst += 4 * vectorSize, src += 4 * vectorSize)
+		{
+			__m256i const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src));
+			__m256i const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + vectorSize));
+			__m256i const c = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + 2 * vectorSize));
+			__m256i const d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + 3 * vectorSize));
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(dst), a);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(dst + vectorSize), b);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 2 * vectorSize), c);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 3 * vectorSize), d);
+		}
+		for (; size >= vectorSize; size -= vectorSize, dst += vectorSize, src += vectorSize)
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(dst), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src)));
+
+		_mm_sfence();
+		memcpy(dst, src, size);
+	}
+
+	bool HasAvx2()
+	{
+#ifdef _MSC_VER
+		// the OS also has to save the upper halves of the ymm registers
+		int info[4]{};
+		__cpuid(info, 1);
+		bool const osSavesYmm{ (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6 };
+		__cpuidex(info, 7, 0);
+		return osSavesYmm && (info[1] & (1 << 5));
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+}
+#endif
+
+void vkc::StreamingCopy(void* dst, void const* src, size_t size)
+{
+#ifdef VKC_STREAMING_SSE2
+	// detected once, the library isn't built with AVX2 enabled so the wider path is picked at runtime
+	static bool const hasAvx2{ HasAvx2() };
+	if (hasAvx2)
+		StreamAvx2(static_cast<char*>(dst), static_cast<char const*>(src), size);
+	else
+		StreamSse2(static_cast<char*>(dst), static_cast<char const*>(src), size);
+#else
+	memcpy(dst, src, size);
+#endif
+}
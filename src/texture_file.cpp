@@ -0,0 +1,242 @@
+#include "texture_file.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+	struct FormatInfo
+	{
+		VkFormat Format;
+		uint32_t DxgiFormat;
+		uint32_t BlockSize;
+		bool     Compressed;
+	};
+
+	constexpr std::array formats
+	{
+		FormatInfo{ VK_FORMAT_R32G32B32A32_SFLOAT, 2, 16, false }
+		, FormatInfo{ VK_FORMAT_R16G16B16A16_SFLOAT, 10, 8, false }
+		, FormatInfo{ VK_FORMAT_R8G8B8A8_UNORM, 28, 4, false }
+		, FormatInfo{ VK_FORMAT_R8G8B8A8_SRGB, 29, 4, false }
+		, FormatInfo{ VK_FORMAT_R16G16_SFLOAT, 34, 4, false }
+		, FormatInfo{ VK_FORMAT_R32_SFLOAT, 41, 4, false }
+		, FormatInfo{ VK_FORMAT_R8G8_UNORM, 49, 2, false }
+		, FormatInfo{ VK_FORMAT_R16_SFLOAT, 54, 2, false }
+		, FormatInfo{ VK_FORMAT_R8_UNORM, 61, 1, false }
+		, FormatInfo{ VK_FORMAT_BC1_RGBA_UNORM_BLOCK, 71, 8, true }
+		, FormatInfo{ VK_FORMAT_BC1_RGBA_SRGB_BLOCK, 72, 8, true }
+		, FormatInfo{ VK_FORMAT_BC2_UNORM_BLOCK, 74, 16, true }
+		, FormatInfo{ VK_FORMAT_BC2_SRGB_BLOCK, 75, 16, true }
+		, FormatInfo{ VK_FORMAT_BC3_UNORM_BLOCK, 77, 16, true }
+		, FormatInfo{ VK_FORMAT_BC3_SRGB_BLOCK, 78, 16, true }
+		, FormatInfo{ VK_FORMAT_BC4_UNORM_BLOCK, 80, 8, true }
+		, FormatInfo{ VK_FORMAT_BC4_SNORM_BLOCK, 81, 8, true }
+		, FormatInfo{ VK_FORMAT_BC5_UNORM_BLOCK, 83, 16, true }
+		, FormatInfo{ VK_FORMAT_BC5_SNORM_BLOCK, 84, 16, true }
+		, FormatInfo{ VK_FORMAT_B8G8R8A8_UNORM, 87, 4, false }
+		, FormatInfo{ VK_FORMAT_B8G8R8A8_SRGB, 91, 4, false }
+		, FormatInfo{ VK_FORMAT_BC6H_UFLOAT_BLOCK, 95, 16, true }
+		, FormatInfo{ VK_FORMAT_BC6H_SFLOAT_BLOCK, 96, 16, true }
+		, FormatInfo{ VK_FORMAT_BC7_UNORM_BLOCK, 98, 16, true }
+		, FormatInfo{ VK_FORMAT_BC7_SRGB_BLOCK, 99, 16, true }
+	};
+
+	FormatInfo const& FindFormat(VkFormat format)
+	{
+		auto const it = std::ranges::find(formats, format, &FormatInfo::Format);
+		if (it == formats.end())
+			throw std::runtime_error("Unsupported texture format " + std::to_string(format));
+		return *it;
+	}
+
+	FormatInfo const& FindDxgiFormat(uint32_t dxgiFormat)
+	{
+		auto const it = std::ranges::find(formats, dxgiFormat, &FormatInfo::DxgiFormat);
+		if (it == formats.end())
+			throw std::runtime_error("Unsupported DXGI format " + std::to_string(dxgiFormat));
+		return *it;
+	}
+
+	constexpr uint32_t MakeFourCC(char const (&code)[5])
+	{
+		return static_cast<uint32_t>(code[0])
+			   | static_cast<uint32_t>(code[1]) << 8
+			   | static_cast<uint32_t>(code[2]) << 16
+			   | static_cast<uint32_t>(code[3]) << 24;
+	}
+
+	constexpr std::array<uint8_t, 12> ktx2Identifier{ 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+}
+
+vkc::TextureFile::TextureFile(std::filesystem::path const& path)
+	: m_File{ std::make_unique<MappedFile>(path) }
+{
+	if (m_File->GetSize() >= ktx2Identifier.size() && memcmp(GetData(), ktx2Identifier.data(), ktx2Identifier.size()) == 0)
+		ParseKtx2();
+	else if (m_File->GetSize() >= 4 && Read<uint32_t>(0) == MakeFourCC("DDS "))
+		ParseDds();
+	else
+		throw std::runtime_error("Unknown texture file format " + path.string());
+}
+
+void vkc::TextureFile::ParseKtx2()
+{
+	m_Format = static_cast<VkFormat>(Read<uint32_t>(12));
+	m_Extent = VkExtent2D{ Read<uint32_t>(20), std::max(Read<uint32_t>(24), 1u) };
+
+	uint32_t const depth{ Read<uint32_t>(28) };
+	uint32_t const layers{ std::max(Read<uint32_t>(32), 1u) };
+	uint32_t const faces{ Read<uint32_t>(36) };
+	uint32_t const levels{ std::max(Read<uint32_t>(40), 1u) };
+	uint32_t const supercompression{ Read<uint32_t>(44) };
+
+	if (m_Format == VK_FORMAT_UNDEFINED || supercompression != 0)
+		throw std::runtime_error("Supercompressed or basis KTX2 textures are not supported");
+	if (depth > 1)
+		throw std::runtime_error("Volume KTX2 textures are not supported");
+	if (faces != 1 && faces != 6)
+		throw std::runtime_error("KTX2 face count has to be 1 or 6");
+	if (layers > UINT32_MAX / faces)
+		throw std::runtime_error("KTX2 layer count out of range");
+
+	FormatInfo const& formatInfo{ FindFormat(m_Format) };
+	m_BlockSize  = formatInfo.BlockSize;
+	m_Compressed = formatInfo.Compressed;
+	m_Cubemap    = faces == 6;
+	m_Layers     = layers * faces;
+
+	// level index follows the 80 byte header, all layers and faces of a level are stored together
+	constexpr size_t levelIndexOffset{ 80 };
+	m_Levels.resize(levels);
+	for (uint32_t mipLevel{ 0 }; mipLevel < levels; ++mipLevel)
+	{
+		size_t const entryOffset{ levelIndexOffset + mipLevel * 3 * sizeof(uint64_t) };
+		auto const   byteOffset = static_cast<size_t>(Read<uint64_t>(entryOffset));
+		auto const   byteLength = static_cast<size_t>(Read<uint64_t>(entryOffset + sizeof(uint64_t)));
+		if (byteOffset > m_File->GetSize() || byteLength > m_File->GetSize() - byteOffset)
+			throw std::runtime_error("KTX2 level data past the end of the file");
+		if (byteLength % m_Layers != 0)
+			throw std::runtime_error("KTX2 level size is not a multiple of its layer count");
+
+		Level& level = m_Levels[mipLevel];
+		level.LayerSize = byteLength / m_Layers;
+		for (uint32_t layer{ 0 }; layer < m_Layers; ++layer)
+			level.LayerOffsets.emplace_back(byteOffset + layer * level.LayerSize);
+	}
+}
+
+void vkc::TextureFile::ParseDds()
+{
+	// offsets relative to the start of the file, the 124 byte header follows the magic
+	constexpr uint32_t mipMapCountFlag{ 0x20000 };
+	constexpr uint32_t fourCCFlag{ 0x4 };
+	constexpr uint32_t rgbFlag{ 0x40 };
+	constexpr uint32_t cubemapCaps{ 0x200 };
+	constexpr uint32_t volumeCaps{ 0x200000 };
+	constexpr uint32_t textureCubeMisc{ 0x4 };
+
+	m_Extent = VkExtent2D{ Read<uint32_t>(16), Read<uint32_t>(12) };
+	// writers may leave garbage in the mip count when the flag isn't set
+	uint32_t const levels{ Read<uint32_t>(8) & mipMapCountFlag ? std::max(Read<uint32_t>(28), 1u) : 1u };
+
+	uint32_t const pixelFlags{ Read<uint32_t>(80) };
+	uint32_t const fourCC{ Read<uint32_t>(84) };
+	uint32_t const caps2{ Read<uint32_t>(112) };
+
+	if (caps2 & volumeCaps)
+		throw std::runtime_error("Volume DDS textures are not supported");
+
+	size_t     dataOffset{ 128 };
+	uint32_t   arraySize{ 1 };
+	FormatInfo formatInfo{};
+
+	if ((pixelFlags & fourCCFlag) && fourCC == MakeFourCC("DX10"))
+	{
+		formatInfo = FindDxgiFormat(Read<uint32_t>(128));
+		if (Read<uint32_t>(132) != 3)
+			throw std::runtime_error("Only 2D DDS textures are supported");
+		m_Cubemap  = Read<uint32_t>(136) & textureCubeMisc;
+		arraySize  = std::max(Read<uint32_t>(140), 1u);
+		dataOffset += 20;
+	}
+	else if (pixelFlags & fourCCFlag)
+	{
+		switch (fourCC)
+		{
+			case MakeFourCC("DXT1"): formatInfo = FindFormat(VK_FORMAT_BC1_RGBA_UNORM_BLOCK);
+				break;
+			case MakeFourCC("DXT2"):
+			case MakeFourCC("DXT3"): formatInfo = FindFormat(VK_FORMAT_BC2_UNORM_BLOCK);
+				break;
+			case MakeFourCC("DXT4"):
+			case MakeFourCC("DXT5"): formatInfo = FindFormat(VK_FORMAT_BC3_UNORM_BLOCK);
+				break;
+			case MakeFourCC("ATI1"):
+			case MakeFourCC("BC4U"): formatInfo = FindFormat(VK_FORMAT_BC4_UNORM_BLOCK);
+				break;
+			case MakeFourCC("ATI2"):
+			case MakeFourCC("BC5U"): formatInfo = FindFormat(VK_FORMAT_BC5_UNORM_BLOCK);
+				break;
+			default: throw std::runtime_error("Unsupported DDS four character code");
+		}
+		m_Cubemap = caps2 & cubemapCaps;
+	}
+	else if ((pixelFlags & rgbFlag) && Read<uint32_t>(88) == 32)
+	{
+		// only 8 bit per channel layouts, told apart by where red lives
+		formatInfo = FindFormat(Read<uint32_t>(92) == 0x000000FF ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_B8G8R8A8_UNORM);
+		m_Cubemap  = caps2 & cubemapCaps;
+	}
+	else
+		throw std::runtime_error("Unsupported DDS pixel format");
+
+	m_Format     = formatInfo.Format;
+	m_BlockSize  = formatInfo.BlockSize;
+	m_Compressed = formatInfo.Compressed;
+	m_Layers     = arraySize * (m_Cubemap ? 6 : 1);
+
+	// every layer holds its full chain before the next one starts
+	m_Levels.resize(levels);
+	for (uint32_t mipLevel{ 0 }; mipLevel < levels; ++mipLevel)
+		m_Levels[mipLevel].LayerSize = GetLevelLayerSize(mipLevel);
+
+	size_t offset{ dataOffset };
+	for (uint32_t layer{ 0 }; layer < m_Layers; ++layer)
+		for (Level& level: m_Levels)
+		{
+			level.LayerOffsets.emplace_back(offset);
+			offset += level.LayerSize;
+		}
+
+	if (offset > m_File->GetSize())
+		throw std::runtime_error("DDS level data past the end of the file");
+}
+
+VkDeviceSize vkc::TextureFile::CalculateSize(VkFormat format, VkExtent2D extent)
+{
+	FormatInfo const& formatInfo{ FindFormat(format) };
+	VkDeviceSize const width{ extent.width };
+	VkDeviceSize const height{ extent.height };
+	if (formatInfo.Compressed)
+		return (width + 3) / 4 * ((height + 3) / 4) * formatInfo.BlockSize;
+	return width * height * formatInfo.BlockSize;
+}
+
+VkDeviceSize vkc::TextureFile::GetLevelLayerSize(uint32_t mipLevel) const
+{
+	return CalculateSize(m_Format, { std::max(m_Extent.width >> mipLevel, 1u), std::max(m_Extent.height >> mipLevel, 1u) });
+}
+
+template<typename T>
+T vkc::TextureFile::Read(size_t offset) const
+{
+	if (offset + sizeof(T) > m_File->GetSize())
+		throw std::runtime_error("Texture header past the end of the file");
+
+	T value{};
+	memcpy(&value, GetData() + offset, sizeof(T));
+	return value;
+}
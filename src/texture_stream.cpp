@@ -0,0 +1,76 @@
+#include "texture_stream.h"
+
+bool vkc::TextureStream::Stream
+(
+	Context const&   context
+	, CommandBuffer& commandBuffer
+	, StagingRing&   stagingRing
+	, VkDeviceSize   byteBudget
+)
+{
+	if (IsComplete())
+		return true;
+
+	if (GetRequiredStagingSize() > stagingRing.GetCapacity())
+		throw std::runtime_error("Failed to stream texture, its largest level does not fit into the staging ring");
+
+	uint32_t const layerCount{ m_File.GetLayerCount() };
+	VkDeviceSize const alignment{ std::max<VkDeviceSize>(16, m_File.GetBlockSize()) };
+
+	// levels [firstMipLevel, m_StreamedMipLevel) are uploaded by this call
+	uint32_t     firstMipLevel{ m_StreamedMipLevel };
+	VkDeviceSize uploadedBytes{ 0 };
+
+	std::vector<Buffer::ImageRegion> regions;
+	while (firstMipLevel > 0)
+	{
+		TextureFile::Level const& level{ m_File.GetLevel(firstMipLevel - 1) };
+		VkDeviceSize const        size{ level.LayerSize * layerCount };
+		if (!regions.empty() && uploadedBytes + size > byteBudget)
+			break;
+
+		std::optional<StagingRing::Allocation> const allocation{ stagingRing.Allocate(context, commandBuffer, size, alignment) };
+		if (!allocation)
+			break;
+
+		for (uint32_t layer{ 0 }; layer < layerCount; ++layer)
+			memcpy(static_cast<std::byte*>(allocation->Data) + layer * level.LayerSize
+				   , m_File.GetData() + level.LayerOffsets[layer]
+				   , level.LayerSize);
+
+		Buffer::ImageRegion& region = regions.emplace_back();
+		region.BufferOffset = allocation->Offset;
+		region.MipLevel     = firstMipLevel - 1;
+		region.LayerCount   = layerCount;
+
+		uploadedBytes += size;
+		--firstMipLevel;
+	}
+
+	if (regions.empty())
+		return false;
+
+	Image::Transition toTransfer{};
+	toTransfer.SrcStageMask  = VK_PIPELINE_STAGE_2_NONE;
+	toTransfer.SrcAccessMask = VK_ACCESS_2_NONE;
+	toTransfer.DstStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+	toTransfer.DstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	toTransfer.NewLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	toTransfer.LayerCount    = layerCount;
+	toTransfer.BaseMipLevel  = firstMipLevel;
+	toTransfer.LevelCount    = m_StreamedMipLevel - firstMipLevel;
+	m_Image.MakeTransition(context, commandBuffer, toTransfer);
+
+	stagingRing.GetBuffer().CopyTo(context, commandBuffer, m_Image, regions);
+
+	Image::Transition toShader{ toTransfer };
+	toShader.SrcStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+	toShader.SrcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	toShader.DstStageMask  = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+	toShader.DstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+	toShader.NewLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	m_Image.MakeTransition(context, commandBuffer, toShader);
+
+	m_StreamedMipLevel = firstMipLevel;
+	return IsComplete();
+}
@@ -0,0 +1,193 @@
+#include "transient_allocator.h"
+
+uint32_t vkc::TransientAllocator::Add(Image& image, Lifetime lifetime)
+{
+	assert(lifetime.FirstUse <= lifetime.LastUse && m_Blocks.empty());
+
+	Resource& resource = m_Resources.emplace_back();
+	resource.Target   = &image;
+	resource.Uses     = lifetime;
+	resource.IsLinear = image.GetTiling() == VK_IMAGE_TILING_LINEAR;
+	return static_cast<uint32_t>(m_Resources.size() - 1);
+}
+
+uint32_t vkc::TransientAllocator::Add(Buffer& buffer, Lifetime lifetime)
+{
+	assert(lifetime.FirstUse <= lifetime.LastUse && m_Blocks.empty());
+
+	Resource& resource = m_Resources.emplace_back();
+	resource.Target   = &buffer;
+	resource.Uses     = lifetime;
+	resource.IsLinear = true;
+	return static_cast<uint32_t>(m_Resources.size() - 1);
+}
+
+void vkc::TransientAllocator::Allocate(Context& context, bool addToQueue)
+{
+	assert(m_Blocks.empty());
+	m_MemoryStats = &context.MemoryStats;
+
+	// resources go into the first block sharing a memory type with them
+	for (Resource& resource: m_Resources)
+	{
+		if (Image* const* image = std::get_if<Image*>(&resource.Target))
+			context.DispatchTable.getImageMemoryRequirements(**image, &resource.Requirements);
+		else
+			context.DispatchTable.getBufferMemoryRequirements(*std::get<Buffer*>(resource.Target), &resource.Requirements);
+
+		auto const block = std::ranges::find_if(m_Blocks, [&resource](Block const& candidate)
+		{
+			return (candidate.Requirements.memoryTypeBits & resource.Requirements.memoryTypeBits) != 0;
+		});
+
+		if (block == m_Blocks.end())
+		{
+			resource.Block = static_cast<uint32_t>(m_Blocks.size());
+			m_Blocks.emplace_back().Requirements.memoryTypeBits = resource.Requirements.memoryTypeBits;
+		}
+		else
+		{
+			resource.Block = static_cast<uint32_t>(block - m_Blocks.begin());
+			block->Requirements.memoryTypeBits &= resource.Requirements.memoryTypeBits;
+		}
+	}
+
+	VkDeviceSize const granularity{ context.Device.physical_device.properties.limits.bufferImageGranularity };
+	for (uint32_t block{ 0 }; block < m_Blocks.size(); ++block)
+	{
+		Pack(block, granularity);
+
+		VmaAllocationCreateInfo allocationCreateInfo{};
+		allocationCreateInfo.usage         = VMA_MEMORY_USAGE_UNKNOWN;
+		allocationCreateInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+		VmaAllocation& allocation = m_Blocks[block].Allocation;
+		if (vmaAllocateMemory(context.Allocator, &m_Blocks[block].Requirements, &allocationCreateInfo, &allocation, nullptr) != VK_SUCCESS)
+			throw std::runtime_error("Failed to allocate transient memory");
+		vmaSetAllocationName(context.Allocator, allocation, "Transient resources");
+		context.MemoryStats.Track(context.Allocator, allocation, "Transient");
+
+		if (addToQueue)
+			context.DeletionQueue.Push([context = &context, allocation]
+			{
+				context->MemoryStats.Untrack(allocation);
+				vmaFreeMemory(context->Allocator, allocation);
+			});
+	}
+
+	for (Resource const& resource: m_Resources)
+	{
+		VmaAllocation const allocation{ m_Blocks[resource.Block].Allocation };
+		std::visit([&context, allocation, &resource](auto* target)
+		{
+			target->BindMemory(context, allocation, resource.Offset);
+		}, resource.Target);
+	}
+}
+
+void vkc::TransientAllocator::Destroy(Context const& context) const
+{
+	for (Block const& block: m_Blocks)
+	{
+		m_MemoryStats->Untrack(block.Allocation);
+		vmaFreeMemory(context.Allocator, block.Allocation);
+	}
+}
+
+vkc::ResourceState vkc::TransientAllocator::GetAliasedState(uint32_t resource) const
+{
+	ResourceState state{ GetState(m_Resources[resource]) };
+	for (uint32_t const alias: m_Resources[resource].Aliases)
+		state.Merge(GetState(m_Resources[alias]));
+	return state;
+}
+
+VkDeviceSize vkc::TransientAllocator::GetAllocatedSize() const
+{
+	VkDeviceSize size{ 0 };
+	for (Block const& block: m_Blocks)
+		size += block.Requirements.size;
+	return size;
+}
+
+VkDeviceSize vkc::TransientAllocator::GetRequestedSize() const
+{
+	VkDeviceSize size{ 0 };
+	for (Resource const& resource: m_Resources)
+		size += resource.Requirements.size;
+	return size;
+}
+
+vkc::ResourceState const& vkc::TransientAllocator::GetState(Resource const& resource)
+{
+	return std::visit([](auto const* target) -> ResourceState const& { return target->GetState(); }, resource.Target);
+}
+
+void vkc::TransientAllocator::Pack(uint32_t block, VkDeviceSize granularity)
+{
+	auto const alignUp = [](VkDeviceSize value, VkDeviceSize alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	};
+
+	std::vector<uint32_t> order;
+	for (uint32_t index{ 0 }; index < m_Resources.size(); ++index)
+		if (m_Resources[index].Block == block)
+			order.push_back(index);
+
+	// first fit by decreasing size colors the interval graph of the lifetimes with memory ranges,
+	// large resources placed first leave fewer holes
+	std::ranges::stable_sort(order, std::ranges::greater{}, [this](uint32_t index) { return m_Resources[index].Requirements.size; });
+
+	struct Range
+	{
+		VkDeviceSize Begin;
+		VkDeviceSize End;
+	};
+
+	VkMemoryRequirements& blockRequirements = m_Blocks[block].Requirements;
+	for (size_t placed{ 0 }; placed < order.size(); ++placed)
+	{
+		Resource& resource = m_Resources[order[placed]];
+
+		// memory of already placed resources alive at the same time
+		std::vector<Range> occupied;
+		for (size_t other{ 0 }; other < placed; ++other)
+		{
+			Resource const& neighbour = m_Resources[order[other]];
+			if (neighbour.Uses.LastUse < resource.Uses.FirstUse || resource.Uses.LastUse < neighbour.Uses.FirstUse)
+				continue;
+
+			Range range{ neighbour.Offset, neighbour.Offset + neighbour.Requirements.size };
+			if (neighbour.IsLinear != resource.IsLinear)
+				range = { range.Begin / granularity * granularity, alignUp(range.End, granularity) };
+			occupied.push_back(range);
+		}
+		std::ranges::sort(occupied, {}, &Range::Begin);
+
+		VkDeviceSize offset{ 0 };
+		for (Range const& range: occupied)
+		{
+			if (offset + resource.Requirements.size <= range.Begin)
+				break;
+			offset = std::max(offset, alignUp(range.End, resource.Requirements.alignment));
+		}
+
+		resource.Offset             = offset;
+		blockRequirements.size      = std::max(blockRequirements.size, offset + resource.Requirements.size);
+		blockRequirements.alignment = std::max(blockRequirements.alignment, resource.Requirements.alignment);
+	}
+
+	// lifetimes of overlapping memory never overlap, their accesses have to be ordered on reuse
+	for (size_t first{ 0 }; first < order.size(); ++first)
+		for (size_t second{ first + 1 }; second < order.size(); ++second)
+		{
+			Resource& a = m_Resources[order[first]];
+			Resource& b = m_Resources[order[second]];
+			if (a.Offset < b.Offset + b.Requirements.size && b.Offset < a.Offset + a.Requirements.size)
+			{
+				a.Aliases.push_back(order[second]);
+				b.Aliases.push_back(order[first]);
+			}
+		}
+}
@@ -0,0 +1,235 @@
+#include "upload_engine.h"
+
+vkc::UploadEngine::UploadEngine(Context& context, VkDeviceSize stagingSize, uint32_t commandBufferCount)
+	: m_TransferFamily{ context.TransferQueueFamily }
+	, m_GraphicsFamily{ context.Device.get_queue_index(vkb::QueueType::graphics).value() }
+	, m_CommandPool{ context, context.TransferQueueFamily, commandBufferCount, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT }
+	, m_StagingRing{ context, stagingSize }
+{
+	assert(context.TransferQueue != VK_NULL_HANDLE && "Context::DiscoverTransferQueue has to be called first");
+
+	VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo{};
+	semaphoreTypeCreateInfo.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	semaphoreTypeCreateInfo.initialValue  = 0;
+
+	VkSemaphoreCreateInfo semaphoreCreateInfo{};
+	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+
+	if (context.DispatchTable.createSemaphore(&semaphoreCreateInfo, nullptr, &m_Timeline) != VK_SUCCESS)
+		throw std::runtime_error("Failed to create upload timeline semaphore");
+
+	context.DeletionQueue.Push([context = &context, semaphore = m_Timeline]
+	{
+		context->DispatchTable.destroySemaphore(semaphore, nullptr);
+	});
+}
+
+bool vkc::UploadEngine::Upload
+(
+	Context&                context
+	, void const*           data
+	, VkDeviceSize          size
+	, Buffer const&         dst
+	, VkDeviceSize          dstOffset
+	, VkPipelineStageFlags2 dstStageMask
+	, VkAccessFlags2        dstAccessMask
+)
+{
+	CommandBuffer& commandBuffer = GetCommandBuffer(context);
+
+	std::optional<StagingRing::Allocation> const allocation{ m_StagingRing.Allocate(context, commandBuffer, size) };
+	if (!allocation)
+		return false;
+
+	memcpy(allocation->Data, data, size);
+	m_StagingRing.CopyTo(context, commandBuffer, *allocation, dst, dstOffset);
+
+	// same family needs no barrier, the timeline semaphore wait already makes the writes visible
+	if (!TransfersOwnership())
+		return true;
+
+	VkBufferMemoryBarrier2 barrier{};
+	barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+	barrier.srcQueueFamilyIndex = m_TransferFamily;
+	barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+	barrier.buffer              = dst;
+	barrier.offset              = dstOffset;
+	barrier.size                = size;
+
+	VkBufferMemoryBarrier2& release = m_BufferReleases.emplace_back(barrier);
+	release.srcStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+	release.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+
+	VkBufferMemoryBarrier2& acquire = m_PendingBufferAcquires.emplace_back(barrier);
+	acquire.dstStageMask  = dstStageMask;
+	acquire.dstAccessMask = dstAccessMask;
+
+	return true;
+}
+
+bool vkc::UploadEngine::Upload
+(
+	Context&                context
+	, void const*           data
+	, VkDeviceSize          size
+	, Image&                dst
+	, VkImageLayout         finalLayout
+	, VkPipelineStageFlags2 dstStageMask
+	, VkAccessFlags2        dstAccessMask
+)
+{
+	CommandBuffer& commandBuffer = GetCommandBuffer(context);
+
+	std::optional<StagingRing::Allocation> const allocation{ m_StagingRing.Allocate(context, commandBuffer, size) };
+	if (!allocation)
+		return false;
+
+	memcpy(allocation->Data, data, size);
+
+	Image::Transition toTransfer{};
+	toTransfer.SrcStageMask  = VK_PIPELINE_STAGE_2_NONE;
+	toTransfer.SrcAccessMask = VK_ACCESS_2_NONE;
+	toTransfer.DstStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+	toTransfer.DstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	toTransfer.NewLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	toTransfer.LayerCount    = dst.GetLayerCount();
+	dst.MakeTransition(context, commandBuffer, toTransfer);
+
+	VkBufferImageCopy2 copyRegion{};
+	copyRegion.sType                           = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2;
+	copyRegion.bufferOffset                    = allocation->Offset;
+	copyRegion.imageExtent                     = VkExtent3D{ dst.GetExtent().width, dst.GetExtent().height, 1 };
+	copyRegion.imageSubresource.aspectMask     = dst.GetAspect();
+	copyRegion.imageSubresource.layerCount     = dst.GetLayerCount();
+	copyRegion.imageSubresource.mipLevel       = 0;
+	copyRegion.imageSubresource.baseArrayLayer = 0;
+
+	VkCopyBufferToImageInfo2 copyImageInfo{};
+	copyImageInfo.sType          = VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2;
+	copyImageInfo.srcBuffer      = m_StagingRing.GetBuffer();
+	copyImageInfo.dstImage       = dst;
+	copyImageInfo.dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	copyImageInfo.regionCount    = 1;
+	copyImageInfo.pRegions       = &copyRegion;
+	context.DispatchTable.cmdCopyBufferToImage2(commandBuffer, &copyImageInfo);
+
+	Image::Transition release{};
+	release.SrcStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+	release.SrcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	release.NewLayout     = finalLayout;
+	release.LayerCount    = dst.GetLayerCount();
+
+	if (!TransfersOwnership())
+	{
+		release.DstStageMask  = dstStageMask;
+		release.DstAccessMask = dstAccessMask;
+		dst.MakeTransition(context, commandBuffer, release);
+		return true;
+	}
+
+	// destination access is ignored on the releasing queue
+	release.SrcQueue = m_TransferFamily;
+	release.DstQueue = m_GraphicsFamily;
+	dst.MakeTransition(context, commandBuffer, release);
+
+	// acquire has to repeat the layout transition of the release
+	VkImageMemoryBarrier2 acquire{};
+	acquire.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+	acquire.dstStageMask                    = dstStageMask;
+	acquire.dstAccessMask                   = dstAccessMask;
+	acquire.oldLayout                       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	acquire.newLayout                       = finalLayout;
+	acquire.srcQueueFamilyIndex             = m_TransferFamily;
+	acquire.dstQueueFamilyIndex             = m_GraphicsFamily;
+	acquire.image                           = dst;
+	acquire.subresourceRange.aspectMask     = dst.GetAspect();
+	acquire.subresourceRange.baseMipLevel   = 0;
+	acquire.subresourceRange.levelCount     = 1;
+	acquire.subresourceRange.baseArrayLayer = 0;
+	acquire.subresourceRange.layerCount     = dst.GetLayerCount();
+	m_PendingImageAcquires.emplace_back(acquire);
+
+	return true;
+}
+
+uint64_t vkc::UploadEngine::Submit(Context& context)
+{
+	if (!m_CommandBuffer)
+		return m_TimelineValue;
+
+	if (!m_BufferReleases.empty())
+	{
+		VkDependencyInfo dependencyInfo{};
+		dependencyInfo.sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(m_BufferReleases.size());
+		dependencyInfo.pBufferMemoryBarriers    = m_BufferReleases.data();
+		context.DispatchTable.cmdPipelineBarrier2(*m_CommandBuffer, &dependencyInfo);
+		m_BufferReleases.clear();
+	}
+
+	m_CommandBuffer->End(context);
+
+	VkSemaphoreSubmitInfo signalInfo{};
+	signalInfo.sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+	signalInfo.semaphore = m_Timeline;
+	signalInfo.value     = ++m_TimelineValue;
+	signalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+	m_CommandBuffer->Submit(context, context.TransferQueue, {}, std::span{ &signalInfo, 1 });
+	m_CommandPool.TrackTimeline(*m_CommandBuffer, m_TimelineValue);
+	m_CommandBuffer = nullptr;
+
+	m_BufferAcquires.insert(m_BufferAcquires.end(), m_PendingBufferAcquires.begin(), m_PendingBufferAcquires.end());
+	m_ImageAcquires.insert(m_ImageAcquires.end(), m_PendingImageAcquires.begin(), m_PendingImageAcquires.end());
+	m_PendingBufferAcquires.clear();
+	m_PendingImageAcquires.clear();
+
+	return m_TimelineValue;
+}
+
+void vkc::UploadEngine::AcquireOwnership(Context const& context, VkCommandBuffer commandBuffer)
+{
+	if (m_BufferAcquires.empty() && m_ImageAcquires.empty())
+		return;
+
+	VkDependencyInfo dependencyInfo{};
+	dependencyInfo.sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(m_BufferAcquires.size());
+	dependencyInfo.pBufferMemoryBarriers    = m_BufferAcquires.data();
+	dependencyInfo.imageMemoryBarrierCount  = static_cast<uint32_t>(m_ImageAcquires.size());
+	dependencyInfo.pImageMemoryBarriers     = m_ImageAcquires.data();
+	context.DispatchTable.cmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+
+	m_BufferAcquires.clear();
+	m_ImageAcquires.clear();
+}
+
+VkSemaphoreSubmitInfo vkc::UploadEngine::GetWaitInfo(VkPipelineStageFlags2 stageMask) const
+{
+	VkSemaphoreSubmitInfo waitInfo{};
+	waitInfo.sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+	waitInfo.semaphore = m_Timeline;
+	waitInfo.value     = m_TimelineValue;
+	waitInfo.stageMask = stageMask;
+	return waitInfo;
+}
+
+uint64_t vkc::UploadEngine::GetCompletedValue(Context const& context) const
+{
+	uint64_t value{};
+	if (context.DispatchTable.getSemaphoreCounterValue(m_Timeline, &value) != VK_SUCCESS)
+		throw std::runtime_error("Failed to query upload timeline semaphore");
+	return value;
+}
+
+vkc::CommandBuffer& vkc::UploadEngine::GetCommandBuffer(Context& context)
+{
+	if (!m_CommandBuffer)
+	{
+		m_CommandBuffer = &m_CommandPool.AllocateCommandBuffer(context);
+		m_CommandBuffer->Begin(context, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	}
+	return *m_CommandBuffer;
+}